@@ -0,0 +1,94 @@
+// g++ -g -O2 -I. -I/usr/include/cryptopp bench-data-txn.cpp -o bench-data-txn.exe -lcryptopp -lpthread
+
+// Latency of the key pairs of a DATA TXN (a, r and the K tryouts) against
+// K, on 1, 4 and 16 threads, over the named groups. "fresh" is a group
+// used just once (SIMD lanes, see simd_modexp.h), "table" a reused one
+// (fixed-base table). The exponent pool is left empty, so every pair is
+// computed.
+//
+// Usage: bench-data-txn.exe [rounds] [group ...]
+
+#include <iostream>
+using std::cout;
+using std::cerr;
+using std::endl;
+
+#include <sstream>
+using std::istringstream;
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include <chrono>
+
+#include "cryptopp/integer.h"
+using CryptoPP::Integer;
+
+#include "named_groups.h"
+#include "key_pairs.h"
+
+int main(int argc, char** argv)
+{
+	unsigned int rounds = 5;
+	vector<string> ids = {"modp1024", "ffdhe2048"};
+
+	if(argc >= 2)
+	{
+		istringstream iss(argv[1]);
+		iss >> rounds;
+	}
+	if(argc >= 3)
+		ids.assign(argv + 2, argv + argc);
+
+	if(rounds == 0)
+	{
+		cerr << "Usage: bench-data-txn.exe [rounds] [group ...]" << endl;
+		return 1;
+	}
+
+	const vector<unsigned int> threads = {1, 4, 16};
+	const vector<int> Ks = {16, 32, 64, 128, 256};
+
+	// Nothing is ever made hot, so take() always misses
+	ExponentPool exponents(0, 0, 0);
+
+	for(const string& id : ids)
+	{
+		const NamedGroup* named = find_named_group(id);
+		if(named == nullptr)
+		{
+			cerr << "Unknown group " << id << endl;
+			continue;
+		}
+		const DHGroup& group = named_group(*named);
+		const Integer max_priv = group.q - 1;
+		const string key = group_key(group.p, group.g);
+
+		// fresh first: once the table exists, every run would use it
+		for(bool reused : {false, true})
+		{
+			for(unsigned int n : threads)
+			{
+				ThreadPool pool(n - 1);
+
+				for(int K : Ks)
+				{
+					vector<Integer> priv(K + 2), pub(K + 2);
+
+					auto begin = std::chrono::steady_clock::now();
+					for(unsigned int i = 0; i < rounds; i++)
+						create_key_pairs(exponents, key, group, max_priv, reused, priv, pub, pool);
+					std::chrono::duration<double, std::milli> d = std::chrono::steady_clock::now() - begin;
+
+					cout << id << "\t" << (reused ? "table" : "fresh") << "\tthreads=" << n
+						<< "\tK=" << K << "\t" << d.count() / rounds << " ms" << endl;
+				}
+			}
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,116 @@
+// g++ -g -O2 -I. -I/usr/include/cryptopp bench-fixed-base.cpp -o bench-fixed-base.exe -lcryptopp -lpthread
+
+// Time of g^x mod G with ModularExponentiation (square-and-multiply)
+// against FixedBaseTable, over the named groups, for exponents of the size
+// of G (g^{g_ab} of a request) and of DH private keys (create_key_pair).
+//
+// Usage: bench-fixed-base.exe [rounds] [group ...]
+
+#include <iostream>
+using std::cout;
+using std::cerr;
+using std::endl;
+
+#include <sstream>
+using std::istringstream;
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include <chrono>
+
+#include "cryptopp/osrng.h"
+using CryptoPP::AutoSeededRandomPool;
+
+#include "cryptopp/integer.h"
+using CryptoPP::Integer;
+
+#include "cryptopp/nbtheory.h"
+using CryptoPP::ModularExponentiation;
+
+#include "cryptopp/dh.h"
+using CryptoPP::DH;
+
+#include "named_groups.h"
+#include "fixed_base.h"
+
+template <class F>
+static double time_us(unsigned int rounds, F&& f)
+{
+	auto begin = std::chrono::steady_clock::now();
+	for(unsigned int i = 0; i < rounds; i++)
+		f(i);
+	std::chrono::duration<double, std::micro> d = std::chrono::steady_clock::now() - begin;
+	return d.count() / rounds;
+}
+
+int main(int argc, char** argv)
+{
+	unsigned int rounds = 200;
+	vector<string> ids = {"modp1024", "modp1536", "ffdhe2048", "modp3072", "ffdhe3072"};
+
+	if(argc >= 2)
+	{
+		istringstream iss(argv[1]);
+		iss >> rounds;
+	}
+	if(argc >= 3)
+		ids.assign(argv + 2, argv + argc);
+
+	if(rounds == 0)
+	{
+		cerr << "Usage: bench-fixed-base.exe [rounds] [group ...]" << endl;
+		return 1;
+	}
+
+	AutoSeededRandomPool rnd;
+
+	for(const string& id : ids)
+	{
+		const NamedGroup* named = find_named_group(id);
+		if(named == nullptr)
+		{
+			cerr << "Unknown group " << id << endl;
+			continue;
+		}
+		const DHGroup& group = named_group(*named);
+
+		DH dh;
+		dh.AccessGroupParameters().Initialize(group.p, group.q, group.g);
+
+		auto begin = std::chrono::steady_clock::now();
+		FixedBaseTable table(group.p, group.g);
+		std::chrono::duration<double, std::milli> setup = std::chrono::steady_clock::now() - begin;
+		cout << id << "\ttable " << table.bytes() / 1024 << " KiB, built in " << setup.count() << "ms" << endl;
+
+		vector<Integer> full, priv;
+		for(unsigned int i = 0; i < rounds; i++)
+		{
+			full.push_back(Integer(rnd, Integer::One(), group.p - 1));
+			priv.push_back(Integer(rnd, Integer::One(), dh.GetGroupParameters().GetMaxExponent()));
+		}
+
+		for(int kind = 0; kind < 2; kind++)
+		{
+			const vector<Integer>& x = kind == 0 ? full : priv;
+
+			double generic = time_us(rounds, [&](unsigned int i) { ModularExponentiation(group.g, x[i], group.p); });
+			double fixed = time_us(rounds, [&](unsigned int i) { table.exponentiate(x[i]); });
+
+			cout << id << "\t" << x[0].BitCount() << "-bit x\tModularExponentiation " << generic
+				<< "us\tFixedBaseTable " << fixed << "us\t" << generic / fixed << "x" << endl;
+
+			for(unsigned int i = 0; i < rounds; i++)
+				if(table.exponentiate(x[i]) != ModularExponentiation(group.g, x[i], group.p))
+				{
+					cerr << "FixedBaseTable mismatch" << endl;
+					return 1;
+				}
+		}
+	}
+
+	return 0;
+}
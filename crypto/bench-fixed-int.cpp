@@ -0,0 +1,161 @@
+// g++ -g -O2 -I. -I/usr/include/cryptopp bench-fixed-int.cpp -o bench-fixed-int.exe -lcryptopp -lpthread
+
+// g_b^a mod G of an ANSWER TXN with FixedMont (fixed_int.h) against
+// ModularExponentiation, over the named groups of the widths the txns
+// dispatch on and over a random odd modulus of each width, which takes
+// the FixedMontCache path. Every result is checked against Crypto++,
+// with short and zero exponents among the random ones, and the hex and
+// byte conversions of FixedInt against those of Integer.
+//
+// Usage: bench-fixed-int.exe [rounds]
+
+#include <iostream>
+using std::cout;
+using std::cerr;
+using std::endl;
+
+#include <sstream>
+using std::istringstream;
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include <chrono>
+
+#include "cryptopp/osrng.h"
+using CryptoPP::AutoSeededRandomPool;
+
+#include "cryptopp/integer.h"
+using CryptoPP::Integer;
+
+#include "cryptopp/nbtheory.h"
+using CryptoPP::ModularExponentiation;
+
+#include "named_groups.h"
+#include "fixed_int.h"
+
+template <class F>
+static double time_ns(unsigned int rounds, F&& f)
+{
+	auto begin = std::chrono::steady_clock::now();
+	for(unsigned int i = 0; i < rounds; i++)
+		f(i);
+	std::chrono::duration<double, std::nano> d = std::chrono::steady_clock::now() - begin;
+	return d.count() / rounds;
+}
+
+template <size_t Bits>
+static FixedInt<Bits> fixed_of(const Integer& x)
+{
+	vector<uint8_t> bytes(Bits / 8);
+	x.Encode(bytes.data(), bytes.size());
+
+	FixedInt<Bits> f;
+	FixedInt<Bits>::from_bytes(bytes.data(), bytes.size(), f);
+	return f;
+}
+
+template <size_t Bits>
+static Integer integer_of(const FixedInt<Bits>& f)
+{
+	vector<uint8_t> bytes(Bits / 8);
+	f.to_bytes(bytes.data());
+	return Integer(bytes.data(), bytes.size());
+}
+
+// Runs and checks the moduli of Bits bits; false on a mismatch
+template <size_t Bits>
+static bool bench(AutoSeededRandomPool& rnd, unsigned int rounds)
+{
+	vector<std::pair<string, Integer>> moduli;
+	for(size_t i = 0; i < NUM_NAMED_GROUPS; i++)
+		if(NAMED_GROUPS[i].bit_size == Bits)
+			moduli.push_back({NAMED_GROUPS[i].id, named_group(NAMED_GROUPS[i]).p});
+
+	Integer n(rnd, Bits);
+	n.SetBit(Bits - 1);
+	n.SetBit(0);
+	moduli.push_back({"random" + std::to_string(Bits), n});
+
+	for(auto& modulus : moduli)
+	{
+		const Integer& G = modulus.second;
+		const FixedInt<Bits> fixed_G = fixed_of<Bits>(G);
+
+		const FixedMont<Bits>* mont = named_fixed_mont(fixed_G);
+		std::shared_ptr<const FixedMont<Bits>> cached;
+		if(mont == nullptr)
+		{
+			cached = FixedMontCache<Bits>::shared().mont(fixed_G);
+			mont = cached.get();
+		}
+
+		vector<Integer> x, e;
+		vector<FixedInt<Bits>> fixed_x, fixed_e;
+		for(unsigned int i = 0; i < rounds; i++)
+		{
+			x.push_back(Integer(rnd, Integer::Two(), G - 2));
+			switch(i % 8)
+			{
+				case 0: e.push_back(Integer::Zero()); break;
+				case 1: e.push_back(Integer(rnd, 1 + i % 64)); break;
+				default: e.push_back(Integer(rnd, Integer::One(), G - 2));
+			}
+			fixed_x.push_back(fixed_of<Bits>(x[i]));
+			fixed_e.push_back(fixed_of<Bits>(e[i]));
+		}
+
+		Integer sink;
+		FixedInt<Bits> fixed_sink;
+		double generic = time_ns(rounds, [&](unsigned int i) { sink = ModularExponentiation(x[i], e[i], G); });
+		double fixed = time_ns(rounds, [&](unsigned int i) { fixed_sink = mont->exponentiate(fixed_x[i], fixed_e[i]); });
+
+		cout << modulus.first << "\tx^e\tModularExponentiation " << generic / 1000 << "us\tFixedMont "
+			<< fixed / 1000 << "us" << endl;
+
+		for(unsigned int i = 0; i < rounds; i++)
+		{
+			FixedInt<Bits> parsed;
+			std::ostringstream hex;
+			hex << std::hex << x[i];
+			string x_hex = hex.str().substr(0, hex.str().size() - 1);
+
+			if(integer_of(mont->exponentiate(fixed_x[i], fixed_e[i])) != ModularExponentiation(x[i], e[i], G)
+				|| integer_of(fixed_x[i]) != x[i]
+				|| !FixedInt<Bits>::from_hex(x_hex, parsed) || !(parsed == fixed_x[i])
+				|| Integer((fixed_x[i].to_hex() + "h").c_str()) != x[i])
+			{
+				cerr << modulus.first << ": FixedMont mismatch" << endl;
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	unsigned int rounds = 200;
+
+	if(argc >= 2)
+	{
+		istringstream iss(argv[1]);
+		iss >> rounds;
+	}
+
+	if(rounds == 0)
+	{
+		cerr << "Usage: bench-fixed-int.exe [rounds]" << endl;
+		return 1;
+	}
+
+	AutoSeededRandomPool rnd;
+
+	if(!bench<1024>(rnd, rounds) || !bench<2048>(rnd, rounds) || !bench<3072>(rnd, rounds))
+		return 1;
+
+	return 0;
+}
@@ -0,0 +1,122 @@
+// g++ -g -O2 -I. -I/usr/include/cryptopp bench-montgomery.cpp -o bench-montgomery.exe -lcryptopp -lpthread
+
+// Per call setup cost of Montgomery arithmetic that MontgomeryContext
+// removes: ModularExponentiation builds a MontgomeryRepresentation and
+// converts its base with a division on every call, while the context only
+// copies its representation and multiplies by R^2. Also times the whole
+// g_b^a mod G of an ANSWER TXN both ways, over the named groups.
+//
+// Usage: bench-montgomery.exe [rounds] [group ...]
+
+#include <iostream>
+using std::cout;
+using std::cerr;
+using std::endl;
+
+#include <sstream>
+using std::istringstream;
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include <chrono>
+
+#include "cryptopp/osrng.h"
+using CryptoPP::AutoSeededRandomPool;
+
+#include "cryptopp/integer.h"
+using CryptoPP::Integer;
+
+#include "cryptopp/nbtheory.h"
+using CryptoPP::ModularExponentiation;
+
+#include "cryptopp/modarith.h"
+using CryptoPP::MontgomeryRepresentation;
+
+#include "named_groups.h"
+#include "montgomery.h"
+
+template <class F>
+static double time_ns(unsigned int rounds, F&& f)
+{
+	auto begin = std::chrono::steady_clock::now();
+	for(unsigned int i = 0; i < rounds; i++)
+		f(i);
+	std::chrono::duration<double, std::nano> d = std::chrono::steady_clock::now() - begin;
+	return d.count() / rounds;
+}
+
+int main(int argc, char** argv)
+{
+	unsigned int rounds = 2000;
+	vector<string> ids = {"modp1024", "modp1536", "ffdhe2048", "modp3072", "ffdhe3072", "ffdhe4096"};
+
+	if(argc >= 2)
+	{
+		istringstream iss(argv[1]);
+		iss >> rounds;
+	}
+	if(argc >= 3)
+		ids.assign(argv + 2, argv + argc);
+
+	if(rounds == 0)
+	{
+		cerr << "Usage: bench-montgomery.exe [rounds] [group ...]" << endl;
+		return 1;
+	}
+
+	AutoSeededRandomPool rnd;
+
+	for(const string& id : ids)
+	{
+		const NamedGroup* named = find_named_group(id);
+		if(named == nullptr)
+		{
+			cerr << "Unknown group " << id << endl;
+			continue;
+		}
+		const Integer& G = named_group(*named).p;
+
+		vector<Integer> x, e;
+		for(unsigned int i = 0; i < rounds; i++)
+		{
+			x.push_back(Integer(rnd, Integer::Two(), G - 2));
+			e.push_back(Integer(rnd, Integer::One(), G - 2));
+		}
+
+		MontgomeryContext context(G);
+		Integer sink;
+
+		double setup = time_ns(rounds, [&](unsigned int i) {
+			MontgomeryRepresentation mr(G);
+			sink = mr.ConvertIn(x[i]);
+		});
+		double reused = time_ns(rounds, [&](unsigned int i) {
+			MontgomeryRepresentation mr = context.arithmetic();
+			sink = context.convert_in(mr, x[i]);
+		});
+
+		cout << id << "\tsetup\tper call " << setup << "ns\tcontext " << reused
+			<< "ns\tsaved " << setup - reused << "ns" << endl;
+
+		unsigned int exp_rounds = std::max(1u, rounds / 10);
+		double generic = time_ns(exp_rounds, [&](unsigned int i) { sink = ModularExponentiation(x[i], e[i], G); });
+		double cached = time_ns(exp_rounds, [&](unsigned int i) { sink = context.exponentiate(x[i], e[i]); });
+
+		cout << id << "\tx^e\tModularExponentiation " << generic / 1000 << "us\tcontext "
+			<< cached / 1000 << "us" << endl;
+
+		for(unsigned int i = 0; i < exp_rounds; i++)
+			if(context.exponentiate(x[i], e[i]) != ModularExponentiation(x[i], e[i], G)
+				|| context.multiply(x[i], e[i]) != x[i] * e[i] % G)
+			{
+				cerr << "MontgomeryContext mismatch" << endl;
+				return 1;
+			}
+	}
+
+	return 0;
+}
@@ -0,0 +1,108 @@
+// g++ -g -O2 -I. -I/usr/include/cryptopp bench-rsa-keygen.cpp -o bench-rsa-keygen.exe -lcryptopp -lpthread
+
+// p50/p99 latency of RSA key generation, the single threaded
+// InvertibleRSAFunction::GenerateRandomWithKeySize (what RSAPair used)
+// against RSAKeyGen searching the primes on a number of threads.
+//
+// Usage: bench-rsa-keygen.exe [threads] [rounds] [bits ...]
+
+#include <iostream>
+using std::cout;
+using std::cerr;
+using std::endl;
+
+#include <sstream>
+using std::istringstream;
+
+#include <vector>
+using std::vector;
+
+#include <thread>
+using std::thread;
+
+#include <chrono>
+#include <algorithm>
+
+#include "cryptopp/osrng.h"
+using CryptoPP::AutoSeededRandomPool;
+
+#include "cryptopp/rsa.h"
+using CryptoPP::InvertibleRSAFunction;
+
+#include "rsa_keygen.h"
+
+static unsigned int parse_arg(const char* arg)
+{
+	unsigned int value = 0;
+	istringstream iss(arg);
+	iss >> value;
+	return iss.fail() ? 0 : value;
+}
+
+template <class F>
+static void report(const char* name, unsigned int bits, unsigned int rounds, F&& f)
+{
+	vector<double> took;
+	for(unsigned int i = 0; i < rounds; i++)
+	{
+		auto begin = std::chrono::steady_clock::now();
+		f();
+		std::chrono::duration<double, std::milli> d = std::chrono::steady_clock::now() - begin;
+		took.push_back(d.count());
+	}
+
+	std::sort(took.begin(), took.end());
+
+	cout << bits << "\t" << name << "\tp50 " << took[rounds / 2]
+		<< "ms\tp99 " << took[std::min<size_t>(rounds - 1, rounds * 99 / 100)]
+		<< "ms\tmax " << took.back() << "ms" << endl;
+}
+
+int main(int argc, char** argv)
+{
+	unsigned int threads = thread::hardware_concurrency();
+	unsigned int rounds = 100;
+	vector<unsigned int> sizes = {2048, 3072};
+
+	if(argc >= 2)
+		threads = parse_arg(argv[1]);
+	if(argc >= 3)
+		rounds = parse_arg(argv[2]);
+	if(argc >= 4)
+	{
+		sizes.clear();
+		for(int i = 3; i < argc; i++)
+			sizes.push_back(parse_arg(argv[i]));
+	}
+
+	if(threads < 2 || rounds == 0)
+	{
+		cerr << "Usage: bench-rsa-keygen.exe [threads >= 2] [rounds] [bits ...]" << endl;
+		return 1;
+	}
+
+	AutoSeededRandomPool rnd;
+	cout << "threads " << threads << ", rounds " << rounds << endl;
+
+	for(unsigned int bits : sizes)
+	{
+		report("GenerateRandomWithKeySize", bits, rounds, [&] {
+			InvertibleRSAFunction rsa;
+			rsa.GenerateRandomWithKeySize(rnd, bits);
+		});
+
+		report("RSAKeyGen", bits, rounds, [&] {
+			RSAKeyGen::generate(bits, threads);
+		});
+
+		// Sanity check of the assembled key
+		InvertibleRSAFunction rsa = RSAKeyGen::generate(bits, threads);
+		if(!rsa.Validate(rnd, 3))
+		{
+			cerr << "RSAKeyGen produced an invalid key" << endl;
+			return 1;
+		}
+	}
+
+	return 0;
+}
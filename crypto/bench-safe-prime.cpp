@@ -0,0 +1,107 @@
+// g++ -g -O2 -I. -I/usr/include/cryptopp bench-safe-prime.cpp -o bench-safe-prime.exe -lcryptopp -lpthread
+
+// Wall clock time to the first safe prime, CryptoPP::PrimeAndGenerator
+// (the single threaded path DataTxn and dh-param used) against
+// SafePrimeSearch on a number of threads.
+//
+// Usage: bench-safe-prime.exe [threads] [rounds] [bits ...]
+
+#include <iostream>
+using std::cout;
+using std::cerr;
+using std::endl;
+
+#include <sstream>
+using std::istringstream;
+
+#include <vector>
+using std::vector;
+
+#include <thread>
+using std::thread;
+
+#include <chrono>
+#include <algorithm>
+
+#include "cryptopp/osrng.h"
+using CryptoPP::AutoSeededRandomPool;
+
+#include "cryptopp/nbtheory.h"
+using CryptoPP::PrimeAndGenerator;
+
+#include "safe_prime.h"
+
+static unsigned int parse_arg(const char* arg)
+{
+	unsigned int value = 0;
+	istringstream iss(arg);
+	iss >> value;
+	return iss.fail() ? 0 : value;
+}
+
+template <class F>
+static void report(const char* name, unsigned int bits, unsigned int rounds, F&& f)
+{
+	vector<double> took;
+	for(unsigned int i = 0; i < rounds; i++)
+	{
+		auto begin = std::chrono::steady_clock::now();
+		f();
+		std::chrono::duration<double> d = std::chrono::steady_clock::now() - begin;
+		took.push_back(d.count());
+	}
+
+	std::sort(took.begin(), took.end());
+
+	double sum = 0;
+	for(double t : took)
+		sum += t;
+
+	cout << bits << "\t" << name << "\tmean " << sum / rounds
+		<< "s\tmin " << took.front() << "s\tmedian " << took[rounds / 2]
+		<< "s\tmax " << took.back() << "s" << endl;
+}
+
+int main(int argc, char** argv)
+{
+	unsigned int threads = thread::hardware_concurrency();
+	unsigned int rounds = 5;
+	vector<unsigned int> sizes = {1024, 2048, 3072};
+
+	if(argc >= 2)
+		threads = parse_arg(argv[1]);
+	if(argc >= 3)
+		rounds = parse_arg(argv[2]);
+	if(argc >= 4)
+	{
+		sizes.clear();
+		for(int i = 3; i < argc; i++)
+			sizes.push_back(parse_arg(argv[i]));
+	}
+
+	if(threads == 0 || rounds == 0)
+	{
+		cerr << "Usage: bench-safe-prime.exe [threads] [rounds] [bits ...]" << endl;
+		return 1;
+	}
+
+	AutoSeededRandomPool rnd;
+	cout << "threads " << threads << ", rounds " << rounds << endl;
+
+	for(unsigned int bits : sizes)
+	{
+		report("PrimeAndGenerator", bits, rounds, [&] {
+			PrimeAndGenerator pg(1, rnd, bits);
+		});
+
+		SieveCounts counts;
+		report("SafePrimeSearch", bits, rounds, [&] {
+			SafePrimeSearch search(bits);
+			search.run(threads);
+			counts += search.counts();
+		});
+		cout << bits << "\tsieve " << counts.to_json() << endl;
+	}
+
+	return 0;
+}
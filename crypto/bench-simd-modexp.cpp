@@ -0,0 +1,114 @@
+// g++ -g -O2 -I. -I/usr/include/cryptopp bench-simd-modexp.cpp -o bench-simd-modexp.exe -lcryptopp -lpthread
+
+// Throughput of independent exponentiations under one modulus: sequential
+// ModularExponentiation against simd_exponentiate with every kernel this
+// CPU runs (the scalar one is the MontgomeryContext fallback), over the
+// named groups, with exponents of the size of G.
+//
+// Usage: bench-simd-modexp.exe [count] [group ...]
+
+#include <iostream>
+using std::cout;
+using std::cerr;
+using std::endl;
+
+#include <sstream>
+using std::istringstream;
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include <chrono>
+
+#include "cryptopp/osrng.h"
+using CryptoPP::AutoSeededRandomPool;
+
+#include "cryptopp/integer.h"
+using CryptoPP::Integer;
+
+#include "cryptopp/nbtheory.h"
+using CryptoPP::ModularExponentiation;
+
+#include "named_groups.h"
+#include "simd_modexp.h"
+
+template <class F>
+static double per_second(unsigned int count, F&& f)
+{
+	auto begin = std::chrono::steady_clock::now();
+	f();
+	std::chrono::duration<double> d = std::chrono::steady_clock::now() - begin;
+	return count / d.count();
+}
+
+int main(int argc, char** argv)
+{
+	unsigned int count = 64;
+	vector<string> ids = {"modp1024", "ffdhe2048"};
+
+	if(argc >= 2)
+	{
+		istringstream iss(argv[1]);
+		iss >> count;
+	}
+	if(argc >= 3)
+		ids.assign(argv + 2, argv + argc);
+
+	if(count == 0)
+	{
+		cerr << "Usage: bench-simd-modexp.exe [count] [group ...]" << endl;
+		return 1;
+	}
+
+	vector<SimdKernel> kernels = {SimdKernel::SCALAR};
+	if(simd_kernel() != SimdKernel::SCALAR)
+		kernels.push_back(SimdKernel::AVX2);
+	if(simd_kernel() == SimdKernel::AVX512_IFMA)
+		kernels.push_back(SimdKernel::AVX512_IFMA);
+
+	AutoSeededRandomPool rnd;
+
+	for(const string& id : ids)
+	{
+		const NamedGroup* named = find_named_group(id);
+		if(named == nullptr)
+		{
+			cerr << "Unknown group " << id << endl;
+			continue;
+		}
+		const Integer& G = named_group(*named).p;
+
+		vector<Integer> bases, exps, expected(count);
+		for(unsigned int i = 0; i < count; i++)
+		{
+			bases.push_back(Integer(rnd, Integer::Two(), G - 2));
+			exps.push_back(Integer(rnd, Integer::One(), G - 2));
+		}
+
+		double sequential = per_second(count, [&] {
+			for(unsigned int i = 0; i < count; i++)
+				expected[i] = ModularExponentiation(bases[i], exps[i], G);
+		});
+		cout << id << "\tModularExponentiation\t" << sequential << "/s" << endl;
+
+		for(SimdKernel kernel : kernels)
+		{
+			vector<Integer> results;
+			double batched = per_second(count, [&] { results = simd_exponentiate(G, bases, exps, kernel); });
+
+			cout << id << "\t" << simd_kernel_name(kernel) << " x" << simd_mont(kernel).lanes << "\t"
+				<< batched << "/s\t" << batched / sequential << "x" << endl;
+
+			if(results != expected)
+			{
+				cerr << simd_kernel_name(kernel) << " mismatch" << endl;
+				return 1;
+			}
+		}
+	}
+
+	return 0;
+}
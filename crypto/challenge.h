@@ -0,0 +1,138 @@
+#ifndef CHALLENGE_H
+#define CHALLENGE_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "cryptopp/cryptlib.h"
+
+// The K challenge bits of a REQUEST TXN, packed 8 to a byte, bit i at
+// bit 7 - i % 8 of byte i / 8 (most significant first); the unused bits
+// of the last byte are zero.
+//
+// On the wire a challenge is either the '0'/'1' string of "req", one
+// character per bit, or the packed bytes as hex in "req_bits", a quarter
+// of the size. K is not part of the packed form: it is the number of
+// tryouts of the data txn.
+class Challenge
+{
+  size_t K;
+  std::vector<CryptoPP::byte> packed;
+
+  static int hex_digit(char c)
+  {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+  }
+
+  void clear_padding()
+  {
+    if (K % 8) {
+      packed.back() &= (CryptoPP::byte)(0xff << (8 - K % 8));
+    }
+  }
+
+  public:
+  Challenge() : K(0) {}
+
+  Challenge(const std::vector<CryptoPP::byte> &bytes, size_t K)
+    : K(K), packed(bytes)
+  {
+    if (packed.size() != (K + 7) / 8) {
+      throw std::invalid_argument("challenge does not have K bits");
+    }
+    clear_padding();
+  }
+
+  // K uniformly random bits out of a single GenerateBlock call
+  static Challenge random(CryptoPP::RandomNumberGenerator &rng, size_t K)
+  {
+    Challenge c;
+    c.K = K;
+    c.packed.resize((K + 7) / 8);
+    if (!c.packed.empty()) {
+      rng.GenerateBlock(c.packed.data(), c.packed.size());
+      c.clear_padding();
+    }
+    return c;
+  }
+
+  // From the '0'/'1' string of "req"
+  static Challenge from_string(const std::string &s)
+  {
+    Challenge c;
+    c.K = s.size();
+    c.packed.assign((c.K + 7) / 8, 0);
+    for (size_t i = 0; i < c.K; i++) {
+      if (s[i] == '1') {
+        c.packed[i / 8] |= (CryptoPP::byte)(0x80 >> (i % 8));
+      }
+      else if (s[i] != '0') {
+        throw std::invalid_argument("challenge bits have to be '0' or '1'");
+      }
+    }
+    return c;
+  }
+
+  // From the hex of "req_bits", for a data txn of K tryouts
+  static Challenge from_hex(const std::string &hex, size_t K)
+  {
+    if (hex.size() != 2 * ((K + 7) / 8)) {
+      throw std::invalid_argument("challenge does not have K bits");
+    }
+
+    std::vector<CryptoPP::byte> bytes(hex.size() / 2);
+    for (size_t i = 0; i < bytes.size(); i++) {
+      int hi = hex_digit(hex[2 * i]);
+      int lo = hex_digit(hex[2 * i + 1]);
+      if (hi < 0 || lo < 0) {
+        throw std::invalid_argument("challenge is not hex");
+      }
+      bytes[i] = (CryptoPP::byte)(hi << 4 | lo);
+    }
+
+    Challenge c(bytes, K);
+    if (c.packed != bytes) {
+      throw std::invalid_argument("challenge has bits beyond K");
+    }
+    return c;
+  }
+
+  size_t size() const { return K; }
+
+  bool operator[](size_t i) const
+  {
+    return (packed[i / 8] >> (7 - i % 8)) & 1;
+  }
+
+  const std::vector<CryptoPP::byte> &bytes() const { return packed; }
+
+  std::string to_string() const
+  {
+    std::string s(K, '0');
+    for (size_t i = 0; i < K; i++) {
+      if ((*this)[i]) {
+        s[i] = '1';
+      }
+    }
+    return s;
+  }
+
+  std::string to_hex() const
+  {
+    static const char DIGITS[] = "0123456789abcdef";
+    std::string s;
+    s.reserve(2 * packed.size());
+    for (CryptoPP::byte b : packed) {
+      s.push_back(DIGITS[b >> 4]);
+      s.push_back(DIGITS[b & 0xf]);
+    }
+    return s;
+  }
+};
+
+#endif
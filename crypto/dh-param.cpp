@@ -15,6 +15,12 @@ using std::runtime_error;
 #include <sstream>
 using std::istringstream;
 
+#include <vector>
+using std::vector;
+
+#include <thread>
+using std::thread;
+
 #include "cryptopp/osrng.h"
 using CryptoPP::AutoSeededRandomPool;
 
@@ -30,10 +36,25 @@ using CryptoPP::DH;
 #include "cryptopp/secblock.h"
 using CryptoPP::SecByteBlock;
 
+#include "group_store.h"
+
+// Usage: dh-param.exe [bits] [count output-file [threads [sieve-bound]]]
+//
+// With only the bit size, one group is generated and printed in hex.
+// In batch mode, count validated groups are written to output-file in
+// the binary format of group_store.h, which main mmaps at startup.
+// The safe prime search runs on all cores unless threads is given.
+// The number of candidates that survived each stage of the search is
+// printed at the end, to tune the sieve bound for a group size.
 int main(int argc, char** argv)
 {
 	AutoSeededRandomPool rnd;
 	unsigned int bits = 2048;
+	unsigned int batch = 0;
+	string output;
+	unsigned int threads = thread::hardware_concurrency();
+	unsigned int sieve_bound = SafePrimeSearch::DEFAULT_SIEVE_BOUND;
+	SieveCounts counts;
 
 	try
 	{
@@ -49,6 +70,65 @@ int main(int argc, char** argv)
 				throw runtime_error("Invalid size in bits");
 		}
 
+		if(argc >= 4)
+		{
+			istringstream iss(argv[2]);
+			iss >> batch;
+
+			if(iss.fail() || batch == 0)
+				throw runtime_error("Failed to parse number of groups");
+
+			output = argv[3];
+		}
+
+		if(argc >= 5)
+		{
+			istringstream iss(argv[4]);
+			iss >> threads;
+
+			if(iss.fail())
+				throw runtime_error("Failed to parse number of threads");
+		}
+
+		if(threads == 0)
+			threads = 1;
+
+		if(argc >= 6)
+		{
+			istringstream iss(argv[5]);
+			iss >> sieve_bound;
+
+			if(iss.fail() || sieve_bound < 5)
+				throw runtime_error("Invalid sieve bound");
+		}
+		else if(argc == 3)
+			throw runtime_error("Batch mode needs both count and output file");
+
+		if(batch > 0)
+		{
+			cout << "Generating " << batch << " groups of size " << bits << " into " << output << endl;
+
+			vector<DHGroup> groups;
+			while(groups.size() < batch)
+			{
+				DHGroup group = generate_group(bits, threads, &counts, sieve_bound);
+
+				// Readers trust the store and never validate again
+				if(!validate_group(rnd, group))
+				{
+					cerr << "Discarding group that failed validation" << endl;
+					continue;
+				}
+
+				groups.push_back(group);
+				cout << "  " << groups.size() << "/" << batch << endl;
+			}
+
+			write_group_store(output, bits, groups);
+			cout << "Sieve (bound " << sieve_bound << "): " << counts.to_json() << endl;
+			return 0;
+		}
+
 		cout << "Generating prime of size " << bits << " and generator" << endl;
 
 		// Safe primes are of the form p = 2q + 1, p and q prime.
@@ -61,10 +141,13 @@ int main(int argc, char** argv)
 		// Also see http://www.cryptopp.com/wiki/Diffie-Hellman and
 		// http://www.cryptopp.com/wiki/Security_level .
 
-		// CryptoPP::DL_GroupParameters_IntegerBased::GenerateRandom (gfpcrypt.cpp)
-		// CryptoPP::PrimeAndGenerator::Generate (nbtheory.cpp)
+		// The search is spread over threads, see SafePrimeSearch (safe_prime.h).
+		// It follows CryptoPP::PrimeAndGenerator::Generate (nbtheory.cpp).
+		DHGroup group = generate_group(bits, threads, &counts, sieve_bound);
+		cout << "Sieve (bound " << sieve_bound << "): " << counts.to_json() << endl;
+
 		DH dh;
-		dh.AccessGroupParameters().GenerateRandomWithKeySize(rnd, bits);
+		dh.AccessGroupParameters().Initialize(group.p, group.q, group.g);
 
 		if(!dh.GetGroupParameters().ValidateGroup(rnd, 3))
 			throw runtime_error("Failed to validate prime and generator");
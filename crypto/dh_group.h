@@ -0,0 +1,68 @@
+#ifndef DH_GROUP_H
+#define DH_GROUP_H
+
+#include <string>
+
+#include "cryptopp/cryptlib.h"
+#include "cryptopp/integer.h"
+#include "cryptopp/nbtheory.h"
+#include "cryptopp/dh.h"
+
+#include "safe_prime.h"
+
+// Parameters of a DH group over a safe prime.
+// p = 2q + 1 where q is prime, and g generates the subgroup of order q.
+struct DHGroup
+{
+  CryptoPP::Integer p;
+  CryptoPP::Integer q;
+  CryptoPP::Integer g;
+};
+
+// Identifies a group (p, g) in the caches of per group state.
+inline std::string group_key(const CryptoPP::Integer &p, const CryptoPP::Integer &g)
+{
+  std::string key(p.MinEncodedSize() + g.MinEncodedSize(), '\0');
+  CryptoPP::byte *out = (CryptoPP::byte *)&key[0];
+
+  p.Encode(out, p.MinEncodedSize());
+  g.Encode(out + p.MinEncodedSize(), g.MinEncodedSize());
+  return key;
+}
+
+// Searches a brand new safe prime group of the given size on num_threads
+// threads. This is the slow path (seconds for 1024 bits, with a large
+// variance), see SafePrimeSearch. When counts is given, the number of
+// candidates that survived each stage of the search is added to it.
+inline DHGroup generate_group(unsigned int bit_size, unsigned int num_threads = 1,
+    SieveCounts *counts = nullptr, uint32_t sieve_bound = SafePrimeSearch::DEFAULT_SIEVE_BOUND)
+{
+  SafePrimeSearch search(bit_size, sieve_bound);
+  search.run(num_threads);
+
+  if (counts != nullptr) {
+    *counts += search.counts();
+  }
+
+  DHGroup group;
+  group.p = search.prime();
+  group.q = search.sub_prime();
+  group.g = search.generator();
+
+  return group;
+}
+
+// Same checks as dh-param.cpp does on a freshly generated group.
+inline bool validate_group(CryptoPP::RandomNumberGenerator &rnd, const DHGroup &group)
+{
+  CryptoPP::DH dh;
+  dh.AccessGroupParameters().Initialize(group.p, group.q, group.g);
+
+  if (!dh.GetGroupParameters().ValidateGroup(rnd, 3)) {
+    return false;
+  }
+
+  return CryptoPP::ModularExponentiation(group.g, group.q, group.p) == CryptoPP::Integer::One();
+}
+
+#endif
@@ -0,0 +1,270 @@
+#ifndef EXPONENT_POOL_H
+#define EXPONENT_POOL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cryptopp/osrng.h"
+#include "cryptopp/integer.h"
+#include "cryptopp/dh.h"
+
+#include "json.hpp"
+#include "dh_group.h"
+#include "fixed_base.h"
+
+// Precomputed ephemeral key pairs (x, g^x mod G) of the groups that get
+// reused, so that create_key_pair on them is a pop instead of a modular
+// exponentiation.
+//
+// A group is reused when it is named (every user shares it), or when
+// more than one txn is made over it, e.g. requests to the same data txn.
+// Background threads keep depth pairs ready for each such group; at most
+// max_groups of them are kept, the least recently used is dropped first.
+// The private exponents live in Integers, whose memory is wiped when they
+// are destroyed.
+class ExponentPool
+{
+  struct KeyPair
+  {
+    CryptoPP::Integer x;
+    CryptoPP::Integer g_x;
+  };
+
+  struct Entry
+  {
+    DHGroup group;
+    std::deque<KeyPair> pairs;
+
+    size_t uses = 0;
+    bool named = false;
+    uint64_t last_used = 0;
+    size_t in_flight = 0;
+
+    size_t hits = 0;
+    size_t misses = 0;
+
+    bool hot() const { return named || uses >= 2; }
+  };
+
+  size_t depth;
+  size_t max_groups;
+
+  // Pairs generated by a worker in one go
+  static const size_t BATCH = 8;
+
+  std::mutex m;
+  std::condition_variable need_refill;
+  std::vector<std::thread> workers;
+  bool stopping = false;
+
+  std::map<std::string, Entry> entries;
+  uint64_t clock = 0;
+  size_t total_hits = 0;
+  size_t total_misses = 0;
+
+  // Hot group with the fewest pairs that is not full yet
+  bool pick_entry(std::string &key)
+  {
+    size_t best_fill = depth;
+    bool picked = false;
+
+    for (auto &kv : entries) {
+      const Entry &entry = kv.second;
+      size_t fill = entry.pairs.size() + entry.in_flight;
+
+      if (entry.hot() && fill < best_fill) {
+        best_fill = fill;
+        key = kv.first;
+        picked = true;
+      }
+    }
+    return picked;
+  }
+
+  // Drops the least recently used groups beyond max_groups, except keep
+  // and those with pairs in flight
+  void evict(const std::string &keep)
+  {
+    while (entries.size() > max_groups) {
+      auto oldest = entries.end();
+      for (auto it = entries.begin(); it != entries.end(); ++it) {
+        if (it->first == keep || it->second.in_flight > 0) {
+          continue;
+        }
+        if (oldest == entries.end() || it->second.last_used < oldest->second.last_used) {
+          oldest = it;
+        }
+      }
+      if (oldest == entries.end()) {
+        return;
+      }
+      entries.erase(oldest);
+    }
+  }
+
+  void refill_loop()
+  {
+    CryptoPP::AutoSeededRandomPool rnd;
+
+    while (true) {
+      std::string key;
+      DHGroup group;
+      size_t count;
+      {
+        std::unique_lock<std::mutex> lock(m);
+        need_refill.wait(lock, [&] { return stopping || pick_entry(key); });
+        if (stopping) {
+          return;
+        }
+
+        Entry &entry = entries[key];
+        group = entry.group;
+        count = std::min((size_t)BATCH, depth - entry.pairs.size() - entry.in_flight);
+        entry.in_flight += count;
+      }
+
+      // Same range of x as DH::GenerateKeyPair
+      CryptoPP::DH dh;
+      dh.AccessGroupParameters().Initialize(group.p, group.q, group.g);
+      const CryptoPP::Integer max_x = dh.GetGroupParameters().GetMaxExponent();
+      auto base = FixedBaseCache::shared().table(group.p, group.g);
+
+      std::vector<KeyPair> made(count);
+      for (KeyPair &pair : made) {
+        pair.x = CryptoPP::Integer(rnd, CryptoPP::Integer::One(), max_x);
+        pair.g_x = base->exponentiate(pair.x);
+      }
+
+      std::lock_guard<std::mutex> lock(m);
+      auto it = entries.find(key);
+      if (it != entries.end()) {
+        it->second.in_flight -= count;
+        for (KeyPair &pair : made) {
+          it->second.pairs.push_back(std::move(pair));
+        }
+      }
+    }
+  }
+
+  public:
+  ExponentPool(size_t depth, size_t max_groups, unsigned int num_threads)
+    : depth(depth), max_groups(max_groups)
+  {
+    for (unsigned int i = 0; i < num_threads; i++) {
+      workers.emplace_back(&ExponentPool::refill_loop, this);
+    }
+  }
+
+  ~ExponentPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m);
+      stopping = true;
+    }
+    need_refill.notify_all();
+
+    for (auto &worker : workers) {
+      worker.join();
+    }
+  }
+
+  ExponentPool(const ExponentPool &) = delete;
+  ExponentPool &operator=(const ExponentPool &) = delete;
+
+  // Records that a txn is made over the group and returns the key to
+  // take its pairs with. named marks a group that every user shares.
+  std::string use(const DHGroup &group, bool named = false)
+  {
+    std::string key = group_key(group.p, group.g);
+
+    std::lock_guard<std::mutex> lock(m);
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+      it = entries.insert(std::make_pair(key, Entry())).first;
+      it->second.group = group;
+    }
+
+    Entry &entry = it->second;
+    entry.uses++;
+    entry.named = entry.named || named;
+    entry.last_used = ++clock;
+
+    // The group just used is the most recent one and stays
+    evict(key);
+
+    if (entry.hot()) {
+      need_refill.notify_one();
+    }
+    return key;
+  }
+
+  // Whether the group of key is reused, i.e. named or used by more than
+  // one txn so far.
+  bool reused(const std::string &key)
+  {
+    std::lock_guard<std::mutex> lock(m);
+    auto it = entries.find(key);
+    return it != entries.end() && it->second.hot();
+  }
+
+  // Pops a precomputed pair of the group. Returns false when there is
+  // none, and the caller has to compute the pair itself.
+  bool take(const std::string &key, CryptoPP::Integer &x, CryptoPP::Integer &g_x)
+  {
+    std::lock_guard<std::mutex> lock(m);
+    auto it = entries.find(key);
+
+    if (it == entries.end() || it->second.pairs.empty()) {
+      total_misses++;
+      if (it != entries.end()) {
+        it->second.misses++;
+      }
+      return false;
+    }
+
+    Entry &entry = it->second;
+    x = std::move(entry.pairs.front().x);
+    g_x = std::move(entry.pairs.front().g_x);
+    entry.pairs.pop_front();
+    entry.hits++;
+    total_hits++;
+
+    need_refill.notify_one();
+    return true;
+  }
+
+  nlohmann::json status()
+  {
+    std::lock_guard<std::mutex> lock(m);
+
+    nlohmann::json groups = nlohmann::json::array();
+    for (auto &kv : entries) {
+      const Entry &entry = kv.second;
+      groups.push_back({
+          {"bit_size", entry.group.p.BitCount()},
+          {"named", entry.named},
+          {"uses", entry.uses},
+          {"available", entry.pairs.size()},
+          {"hits", entry.hits},
+          {"misses", entry.misses}});
+    }
+
+    size_t total = total_hits + total_misses;
+    return {
+      {"depth", depth},
+      {"hits", total_hits},
+      {"misses", total_misses},
+      {"hit_rate", total > 0 ? (double)total_hits / total : 0.0},
+      {"groups", groups}
+    };
+  }
+};
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef FIAT_SHAMIR_H
+#define FIAT_SHAMIR_H
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "cryptopp/sha.h"
+
+#include "challenge.h"
+
+// Non-interactive challenges (Fiat-Shamir). Instead of the requester
+// drawing the K challenge bits at random, they are derived from a hash of
+// everything the proof is about: the commitments of the DATA TXN and the
+// g_b, g_g_ab_p_r of the REQUEST TXN. The data owner cannot pick them
+// (its commitments are fixed before the request exists), anybody can
+// recompute them, and the answer can be made as soon as the request is
+// seen instead of after it is committed in a block.
+
+// Commitments of a data txn, as hex
+struct FiatShamirContext
+{
+  std::string G;
+  std::string g;
+  std::string g_a;
+  std::string g_r;
+  std::vector<std::string> g_r_i;
+};
+
+namespace fiat_shamir_detail
+{
+  // Hex as it is hashed: lower case without leading zeros, so that the
+  // way a party formats its numbers does not change the challenge.
+  inline std::string normalized(const std::string &hex)
+  {
+    std::string s;
+    for (char c : hex) {
+      c = (c >= 'A' && c <= 'F') ? c | 0x20 : c;
+      if (c != '0' || !s.empty()) {
+        s.push_back(c);
+      }
+    }
+    return s.empty() ? "0" : s;
+  }
+
+  // Length prefixed, so that no two transcripts hash the same bytes
+  inline void absorb(CryptoPP::SHA256 &hash, const std::string &hex)
+  {
+    std::string s = normalized(hex);
+    uint32_t len = s.size();
+    CryptoPP::byte prefix[4] = {
+      (CryptoPP::byte)(len >> 24), (CryptoPP::byte)(len >> 16),
+      (CryptoPP::byte)(len >> 8), (CryptoPP::byte)len};
+
+    hash.Update(prefix, sizeof(prefix));
+    hash.Update((const CryptoPP::byte *)s.data(), s.size());
+  }
+}
+
+// K = data.g_r_i.size() challenge bits, '0' or '1', the format of "req".
+// The bits are SHA-256(digest || counter) for counter = 0, 1, ..., most
+// significant bit first, where digest hashes the whole transcript.
+inline std::string fiat_shamir_challenge(const FiatShamirContext &data,
+    const std::string &g_b, const std::string &g_g_ab_p_r)
+{
+  static const char TAG[] = "chainge zkp fiat-shamir v1";
+
+  CryptoPP::SHA256 hash;
+  hash.Update((const CryptoPP::byte *)TAG, sizeof(TAG) - 1);
+
+  fiat_shamir_detail::absorb(hash, data.G);
+  fiat_shamir_detail::absorb(hash, data.g);
+  fiat_shamir_detail::absorb(hash, data.g_a);
+  fiat_shamir_detail::absorb(hash, data.g_r);
+  fiat_shamir_detail::absorb(hash, std::to_string(data.g_r_i.size()));
+  for (auto &g_r_i : data.g_r_i) {
+    fiat_shamir_detail::absorb(hash, g_r_i);
+  }
+  fiat_shamir_detail::absorb(hash, g_b);
+  fiat_shamir_detail::absorb(hash, g_g_ab_p_r);
+
+  CryptoPP::byte digest[CryptoPP::SHA256::DIGESTSIZE];
+  hash.Final(digest);
+
+  const size_t K = data.g_r_i.size();
+  const size_t BLOCK = CryptoPP::SHA256::DIGESTSIZE;
+  std::vector<CryptoPP::byte> bits((K + 7) / 8);
+
+  for (uint32_t counter = 0; BLOCK * counter < bits.size(); counter++) {
+    CryptoPP::byte block[BLOCK];
+    CryptoPP::byte c[4] = {
+      (CryptoPP::byte)(counter >> 24), (CryptoPP::byte)(counter >> 16),
+      (CryptoPP::byte)(counter >> 8), (CryptoPP::byte)counter};
+
+    CryptoPP::SHA256 expand;
+    expand.Update(digest, sizeof(digest));
+    expand.Update(c, sizeof(c));
+    expand.Final(block);
+
+    size_t n = std::min(BLOCK, bits.size() - BLOCK * counter);
+    std::copy(block, block + n, bits.begin() + BLOCK * counter);
+  }
+  return Challenge(bits, K).to_string();
+}
+
+#endif
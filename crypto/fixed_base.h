@@ -0,0 +1,191 @@
+#ifndef FIXED_BASE_H
+#define FIXED_BASE_H
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "cryptopp/integer.h"
+#include "cryptopp/nbtheory.h"
+
+#include "json.hpp"
+#include "dh_group.h"
+#include "montgomery.h"
+
+// Powers of a fixed base g mod G, precomputed so that g^x takes only
+// multiplications and no squarings (fixed-base windowing).
+//
+// With x = sum d_j 2^(4j), the table holds g^(d 2^(4j)) for every digit
+// d = 1 ... 15 and position j, so g^x is the product of one entry per
+// nonzero digit: about |x| / 4 Montgomery multiplications instead of
+// |x| squarings plus the multiplications of square-and-multiply. The
+// table covers exponents up to one bit longer than G (sums like the
+// r_i + r + g_ab of an answer), e.g. 480 KiB for 1024 bits.
+class FixedBaseTable
+{
+  static const unsigned int WINDOW = 4;
+  static const unsigned int DIGITS = (1 << WINDOW) - 1;
+
+  CryptoPP::Integer G;
+  CryptoPP::Integer g;
+  unsigned int max_bits;
+
+  std::shared_ptr<const MontgomeryContext> mont;
+
+  // table[j * DIGITS + d - 1] = g^(d 2^(WINDOW j)), in Montgomery form
+  std::vector<CryptoPP::Integer> table;
+
+  public:
+  FixedBaseTable(const CryptoPP::Integer &G, const CryptoPP::Integer &g)
+    : G(G), g(g), max_bits(G.BitCount() + 1), mont(MontgomeryCache::shared().context(G))
+  {
+    CryptoPP::MontgomeryRepresentation mr = mont->arithmetic();
+
+    size_t positions = (max_bits + WINDOW - 1) / WINDOW;
+    table.reserve(positions * DIGITS);
+
+    CryptoPP::Integer base = mont->convert_in(mr, g % G);
+    for (size_t j = 0; j < positions; j++) {
+      CryptoPP::Integer power = base;
+      table.push_back(power);
+
+      for (unsigned int d = 2; d <= DIGITS; d++) {
+        power = mr.Multiply(power, base);
+        table.push_back(power);
+      }
+
+      // base^(2^WINDOW) for the next position
+      base = mr.Multiply(power, base);
+    }
+  }
+
+  // g^x mod G. Longer exponents take the generic path.
+  CryptoPP::Integer exponentiate(const CryptoPP::Integer &x) const
+  {
+    if (x.IsNegative() || x.BitCount() > max_bits) {
+      return CryptoPP::ModularExponentiation(g, x, G);
+    }
+
+    CryptoPP::MontgomeryRepresentation mr = mont->arithmetic();
+    CryptoPP::Integer result;
+    bool empty = true;
+
+    for (size_t j = 0; j * WINDOW < x.BitCount(); j++) {
+      unsigned int d = (unsigned int)x.GetBits(j * WINDOW, WINDOW);
+      if (d == 0) {
+        continue;
+      }
+
+      const CryptoPP::Integer &entry = table[j * DIGITS + d - 1];
+      if (empty) {
+        result = entry;
+        empty = false;
+      }
+      else {
+        result = mr.Multiply(result, entry);
+      }
+    }
+
+    return empty ? CryptoPP::Integer::One() : mr.ConvertOut(result);
+  }
+
+  size_t bytes() const { return table.size() * G.ByteCount(); }
+};
+
+// Fixed-base tables of the groups in use, keyed by (G, g). The cache is
+// bounded by the memory of its tables; the least recently used table is
+// dropped first. Tables are read only once built, so all threads share
+// them.
+class FixedBaseCache
+{
+  typedef std::shared_ptr<const FixedBaseTable> Table;
+
+  size_t max_bytes;
+
+  std::mutex m;
+  size_t bytes = 0;
+  size_t hits = 0;
+  size_t misses = 0;
+
+  // Most recently used key at the front
+  std::list<std::string> lru;
+  std::map<std::string, std::pair<Table, std::list<std::string>::iterator>> entries;
+
+  public:
+  explicit FixedBaseCache(size_t max_bytes) : max_bytes(max_bytes) {}
+
+  Table table(const CryptoPP::Integer &G, const CryptoPP::Integer &g)
+  {
+    std::string key = group_key(G, g);
+    {
+      std::lock_guard<std::mutex> lock(m);
+      auto it = entries.find(key);
+      if (it != entries.end()) {
+        hits++;
+        lru.splice(lru.begin(), lru, it->second.second);
+        return it->second.first;
+      }
+      misses++;
+    }
+
+    // Build outside of the lock; two threads may race to build the same
+    // table, which is harmless.
+    Table built = std::make_shared<const FixedBaseTable>(G, g);
+
+    std::lock_guard<std::mutex> lock(m);
+    if (entries.count(key)) {
+      return entries[key].first;
+    }
+
+    lru.push_front(key);
+    entries[key] = std::make_pair(built, lru.begin());
+    bytes += built->bytes();
+
+    // Keep at least the table just built, however large it is
+    while (bytes > max_bytes && entries.size() > 1) {
+      bytes -= entries[lru.back()].first->bytes();
+      entries.erase(lru.back());
+      lru.pop_back();
+    }
+    return built;
+  }
+
+  // The table of (G, g) if it is cached, without building one
+  Table find(const CryptoPP::Integer &G, const CryptoPP::Integer &g)
+  {
+    std::string key = group_key(G, g);
+
+    std::lock_guard<std::mutex> lock(m);
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+      return nullptr;
+    }
+
+    hits++;
+    lru.splice(lru.begin(), lru, it->second.second);
+    return it->second.first;
+  }
+
+  nlohmann::json status()
+  {
+    std::lock_guard<std::mutex> lock(m);
+    return {
+      {"tables", entries.size()},
+      {"bytes", bytes},
+      {"hits", hits},
+      {"misses", misses}
+    };
+  }
+
+  // Cache shared by the whole calculator.
+  static FixedBaseCache &shared()
+  {
+    static FixedBaseCache cache(64 << 20);
+    return cache;
+  }
+};
+
+#endif
@@ -0,0 +1,467 @@
+#ifndef FIXED_INT_H
+#define FIXED_INT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "named_groups.h"
+
+// Unsigned integers of a width fixed at compile time, for the arithmetic
+// of a request over a group of one of the common sizes (see the widths
+// the txns dispatch on in main.cpp). The limbs live in a std::array, so
+// unlike CryptoPP::Integer no temporary touches the heap, and every loop
+// runs over a constant number of limbs, which the compiler unrolls.
+//
+// Limbs are 64 bits, least significant first.
+
+#if defined(__GNUC__) && !defined(__clang__)
+#define FIXED_INT_UNROLL _Pragma("GCC unroll 64")
+#else
+#define FIXED_INT_UNROLL
+#endif
+
+typedef unsigned __int128 fixed_int_wide;
+
+template <size_t Bits>
+struct FixedInt
+{
+  static_assert(Bits % 64 == 0, "FixedInt is made of 64-bit limbs");
+  static const size_t LIMBS = Bits / 64;
+
+  std::array<uint64_t, LIMBS> limb;
+
+  FixedInt() : limb() {}
+
+  explicit FixedInt(const std::array<uint64_t, LIMBS> &limb) : limb(limb) {}
+
+  // From big endian hex as integer_to_string writes it; false when the
+  // number does not fit or is not hex.
+  static bool from_hex(const std::string &hex, FixedInt &out)
+  {
+    out = FixedInt();
+    size_t bits = 0;
+
+    for (size_t k = hex.size(); k-- > 0; bits += 4) {
+      char c = hex[k];
+      uint64_t d;
+      if (c >= '0' && c <= '9') {
+        d = c - '0';
+      }
+      else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f') {
+        d = (c | 0x20) - 'a' + 10;
+      }
+      else {
+        return false;
+      }
+
+      if (bits >= Bits) {
+        if (d != 0) {
+          return false;
+        }
+        continue;
+      }
+      out.limb[bits / 64] |= d << (bits % 64);
+    }
+    return !hex.empty();
+  }
+
+  // Lower case hex without leading zeros, the same as integer_to_string
+  std::string to_hex() const
+  {
+    static const char digits[] = "0123456789abcdef";
+
+    std::string hex;
+    hex.reserve(Bits / 4);
+    for (size_t k = Bits / 4; k-- > 0;) {
+      unsigned int d = (limb[k / 16] >> (4 * (k % 16))) & 0xf;
+      if (d != 0 || !hex.empty()) {
+        hex.push_back(digits[d]);
+      }
+    }
+    return hex.empty() ? "0" : hex;
+  }
+
+  // From big endian bytes as Integer::Encode writes them; false when the
+  // number does not fit.
+  static bool from_bytes(const uint8_t *bytes, size_t size, FixedInt &out)
+  {
+    out = FixedInt();
+    for (size_t k = 0; k < size; k++) {
+      uint8_t b = bytes[size - 1 - k];
+      if (k >= Bits / 8) {
+        if (b != 0) {
+          return false;
+        }
+        continue;
+      }
+      out.limb[k / 8] |= (uint64_t)b << (8 * (k % 8));
+    }
+    return true;
+  }
+
+  // Big endian, Bits / 8 bytes
+  void to_bytes(uint8_t *bytes) const
+  {
+    for (size_t k = 0; k < Bits / 8; k++) {
+      bytes[Bits / 8 - 1 - k] = (uint8_t)(limb[k / 8] >> (8 * (k % 8)));
+    }
+  }
+
+  // Zero extended (or truncated) to another width
+  template <size_t Other>
+  FixedInt<Other> resize() const
+  {
+    FixedInt<Other> x;
+    for (size_t i = 0; i < LIMBS && i < FixedInt<Other>::LIMBS; i++) {
+      x.limb[i] = limb[i];
+    }
+    return x;
+  }
+
+  bool bit(size_t i) const { return (limb[i / 64] >> (i % 64)) & 1; }
+
+  // Bits i ... i + n - 1, for n < 64 that do not straddle a limb
+  unsigned int bits(size_t i, unsigned int n) const
+  {
+    return (limb[i / 64] >> (i % 64)) & ((1ULL << n) - 1);
+  }
+
+  bool top_bit() const { return limb[LIMBS - 1] >> 63; }
+
+  bool is_zero() const
+  {
+    uint64_t any = 0;
+    FIXED_INT_UNROLL
+    for (size_t i = 0; i < LIMBS; i++) {
+      any |= limb[i];
+    }
+    return any == 0;
+  }
+
+  // this += b, returns the carry out
+  uint64_t add(const FixedInt &b)
+  {
+    uint64_t carry = 0;
+    FIXED_INT_UNROLL
+    for (size_t i = 0; i < LIMBS; i++) {
+      fixed_int_wide s = (fixed_int_wide)limb[i] + b.limb[i] + carry;
+      limb[i] = (uint64_t)s;
+      carry = (uint64_t)(s >> 64);
+    }
+    return carry;
+  }
+
+  // this -= b, returns the borrow out
+  uint64_t sub(const FixedInt &b)
+  {
+    uint64_t borrow = 0;
+    FIXED_INT_UNROLL
+    for (size_t i = 0; i < LIMBS; i++) {
+      fixed_int_wide d = (fixed_int_wide)limb[i] - b.limb[i] - borrow;
+      limb[i] = (uint64_t)d;
+      borrow = (uint64_t)(d >> 64) & 1;
+    }
+    return borrow;
+  }
+
+  int compare(const FixedInt &b) const
+  {
+    for (size_t i = LIMBS; i-- > 0;) {
+      if (limb[i] != b.limb[i]) {
+        return limb[i] < b.limb[i] ? -1 : 1;
+      }
+    }
+    return 0;
+  }
+
+  bool operator==(const FixedInt &b) const { return limb == b.limb; }
+  bool operator!=(const FixedInt &b) const { return limb != b.limb; }
+};
+
+// -n^-1 mod 2^64 of an odd n0, by Newton's iteration (each step doubles
+// the number of correct low bits, n0 itself is right in the lowest 3).
+constexpr uint64_t fixed_inverse_step(uint64_t n0, uint64_t x, int steps)
+{
+  return steps == 0 ? 0 - x : fixed_inverse_step(n0, x * (2 - n0 * x), steps - 1);
+}
+
+constexpr uint64_t fixed_neg_inverse(uint64_t n0)
+{
+  return fixed_inverse_step(n0, n0, 5);
+}
+
+// Arithmetic mod an odd n of exactly Bits bits, in Montgomery form with
+// R = 2^Bits. mul is CIOS (interleaved multiplication and reduction) over
+// the limbs, with the final subtraction so that results are below n.
+template <size_t Bits>
+class FixedMont
+{
+  static const size_t N = FixedInt<Bits>::LIMBS;
+
+  FixedInt<Bits> n;
+  uint64_t n0;
+
+  // R mod n (1 in Montgomery form) and R^2 mod n
+  FixedInt<Bits> one;
+  FixedInt<Bits> r2;
+
+  public:
+  // n has to be odd with its top bit set
+  FixedMont(const FixedInt<Bits> &n, uint64_t n0) : n(n), n0(n0)
+  {
+    // R mod n = 2^Bits - n, since n > 2^(Bits - 1)
+    one = FixedInt<Bits>();
+    one.sub(n);
+
+    // R^2 mod n by doubling R mod n Bits times
+    r2 = one;
+    for (size_t i = 0; i < Bits; i++) {
+      uint64_t carry = r2.add(r2);
+      if (carry || r2.compare(n) >= 0) {
+        r2.sub(n);
+      }
+    }
+  }
+
+  explicit FixedMont(const FixedInt<Bits> &n) : FixedMont(n, fixed_neg_inverse(n.limb[0])) {}
+
+  const FixedInt<Bits> &modulus() const { return n; }
+
+  // r = a b R^-1 mod n, for a, b below n. r may alias a or b.
+  void mul(FixedInt<Bits> &r, const FixedInt<Bits> &a, const FixedInt<Bits> &b) const
+  {
+    uint64_t t[N + 2] = {0};
+
+    for (size_t i = 0; i < N; i++) {
+      uint64_t carry = 0;
+      FIXED_INT_UNROLL
+      for (size_t j = 0; j < N; j++) {
+        fixed_int_wide s = (fixed_int_wide)a.limb[j] * b.limb[i] + t[j] + carry;
+        t[j] = (uint64_t)s;
+        carry = (uint64_t)(s >> 64);
+      }
+      fixed_int_wide s = (fixed_int_wide)t[N] + carry;
+      t[N] = (uint64_t)s;
+      t[N + 1] = (uint64_t)(s >> 64);
+
+      uint64_t m = t[0] * n0;
+      s = (fixed_int_wide)m * n.limb[0] + t[0];
+      carry = (uint64_t)(s >> 64);
+      FIXED_INT_UNROLL
+      for (size_t j = 1; j < N; j++) {
+        s = (fixed_int_wide)m * n.limb[j] + t[j] + carry;
+        t[j - 1] = (uint64_t)s;
+        carry = (uint64_t)(s >> 64);
+      }
+      s = (fixed_int_wide)t[N] + carry;
+      t[N - 1] = (uint64_t)s;
+      t[N] = t[N + 1] + (uint64_t)(s >> 64);
+    }
+
+    FIXED_INT_UNROLL
+    for (size_t j = 0; j < N; j++) {
+      r.limb[j] = t[j];
+    }
+    if (t[N] != 0 || r.compare(n) >= 0) {
+      r.sub(n);
+    }
+  }
+
+  FixedInt<Bits> convert_in(const FixedInt<Bits> &x) const
+  {
+    FixedInt<Bits> y;
+    mul(y, x, r2);
+    return y;
+  }
+
+  FixedInt<Bits> convert_out(const FixedInt<Bits> &x) const
+  {
+    FixedInt<Bits> unit, y;
+    unit.limb[0] = 1;
+    mul(y, x, unit);
+    return y;
+  }
+
+  // x^e mod n for x below n, with a 4-bit fixed window
+  template <size_t ExpBits>
+  FixedInt<Bits> exponentiate(const FixedInt<Bits> &x, const FixedInt<ExpBits> &e) const
+  {
+    FixedInt<Bits> table[16];
+    table[0] = one;
+    table[1] = convert_in(x);
+    for (unsigned int d = 2; d < 16; d++) {
+      mul(table[d], table[d - 1], table[1]);
+    }
+
+    // Squaring one through the leading zero windows of e gives one, so
+    // start at the top nonzero window (e of a 1024-bit group is often
+    // well short of ExpBits).
+    size_t j = ExpBits / 4;
+    while (j > 0 && e.bits(4 * (j - 1), 4) == 0) {
+      j--;
+    }
+    if (j == 0) {
+      return convert_out(one);
+    }
+
+    FixedInt<Bits> acc = table[e.bits(4 * --j, 4)];
+    while (j-- > 0) {
+      for (int k = 0; k < 4; k++) {
+        mul(acc, acc, acc);
+      }
+      mul(acc, acc, table[e.bits(4 * j, 4)]);
+    }
+    return convert_out(acc);
+  }
+};
+
+// Moduli of the named groups as limbs, parsed from their hex at compile
+// time. The hex of a group of b bits has exactly b / 4 digits.
+namespace fixed_int_detail
+{
+  template <size_t... I> struct Indices {};
+  template <size_t N, size_t... I> struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {};
+  template <size_t... I> struct MakeIndices<0, I...> { typedef Indices<I...> type; };
+
+  constexpr uint64_t hex_digit(char c)
+  {
+    return c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10;
+  }
+
+  constexpr uint64_t hex_range(const char *hex, size_t pos, size_t end, uint64_t acc)
+  {
+    return pos == end ? acc : hex_range(hex, pos + 1, end, (acc << 4) | hex_digit(hex[pos]));
+  }
+
+  // Limb i of the len digits of hex
+  constexpr uint64_t hex_limb(const char *hex, size_t len, size_t i)
+  {
+    return 16 * (i + 1) > len ? 0 : hex_range(hex, len - 16 * (i + 1), len - 16 * i, 0);
+  }
+
+  template <size_t Limbs, size_t... I>
+  constexpr std::array<uint64_t, Limbs> limbs_of(const NamedGroup &named, Indices<I...>)
+  {
+    return {{hex_limb(named.p_hex, named.bit_size / 4, I)...}};
+  }
+
+  // Modulus and -n^-1 mod 2^64 of a named group, for the groups of other
+  // sizes the limbs are meaningless and never used.
+  template <size_t Bits>
+  struct Modulus
+  {
+    std::array<uint64_t, Bits / 64> n;
+    uint64_t n0;
+  };
+
+  template <size_t Bits>
+  constexpr Modulus<Bits> modulus_of(const NamedGroup &named)
+  {
+    return {limbs_of<Bits / 64>(named, typename MakeIndices<Bits / 64>::type()),
+      fixed_neg_inverse(hex_limb(named.p_hex, named.bit_size / 4, 0))};
+  }
+
+  template <size_t Bits, size_t... G>
+  constexpr std::array<Modulus<Bits>, sizeof...(G)> all_moduli(Indices<G...>)
+  {
+    return {{modulus_of<Bits>(NAMED_GROUPS[G])...}};
+  }
+}
+
+// Arithmetic of the named group with modulus n, if there is one of this
+// width. Its constants come from compile time; only R^2 is set up once.
+template <size_t Bits>
+const FixedMont<Bits> *named_fixed_mont(const FixedInt<Bits> &n)
+{
+  typedef fixed_int_detail::Modulus<Bits> Modulus;
+  static constexpr std::array<Modulus, NUM_NAMED_GROUPS> MODULI =
+    fixed_int_detail::all_moduli<Bits>(fixed_int_detail::MakeIndices<NUM_NAMED_GROUPS>::type());
+
+  static const std::array<FixedMont<Bits> *, NUM_NAMED_GROUPS> monts = [] {
+    std::array<FixedMont<Bits> *, NUM_NAMED_GROUPS> m;
+    for (size_t i = 0; i < NUM_NAMED_GROUPS; i++) {
+      m[i] = NAMED_GROUPS[i].bit_size == Bits ?
+        new FixedMont<Bits>(FixedInt<Bits>(MODULI[i].n), MODULI[i].n0) : nullptr;
+    }
+    return m;
+  }();
+
+  for (size_t i = 0; i < NUM_NAMED_GROUPS; i++) {
+    if (monts[i] != nullptr && monts[i]->modulus() == n) {
+      return monts[i];
+    }
+  }
+  return nullptr;
+}
+
+// Arithmetic of the other moduli of this width in use, shared across
+// requests and threads the way MontgomeryCache shares its contexts; the
+// least recently used one is dropped first.
+template <size_t Bits>
+class FixedMontCache
+{
+  typedef std::shared_ptr<const FixedMont<Bits>> Mont;
+
+  size_t capacity;
+
+  std::mutex m;
+
+  // Most recently used modulus at the front
+  std::list<std::string> lru;
+  std::map<std::string, std::pair<Mont, std::list<std::string>::iterator>> entries;
+
+  static std::string key_of(const FixedInt<Bits> &n)
+  {
+    std::string key(Bits / 8, '\0');
+    n.to_bytes((uint8_t *)&key[0]);
+    return key;
+  }
+
+  public:
+  explicit FixedMontCache(size_t capacity) : capacity(capacity) {}
+
+  // n has to be odd with its top bit set
+  Mont mont(const FixedInt<Bits> &n)
+  {
+    std::string key = key_of(n);
+    {
+      std::lock_guard<std::mutex> lock(m);
+      auto it = entries.find(key);
+      if (it != entries.end()) {
+        lru.splice(lru.begin(), lru, it->second.second);
+        return it->second.first;
+      }
+    }
+
+    Mont built = std::make_shared<const FixedMont<Bits>>(n);
+
+    std::lock_guard<std::mutex> lock(m);
+    if (entries.count(key)) {
+      return entries[key].first;
+    }
+
+    lru.push_front(key);
+    entries[key] = std::make_pair(built, lru.begin());
+
+    if (entries.size() > capacity) {
+      entries.erase(lru.back());
+      lru.pop_back();
+    }
+    return built;
+  }
+
+  // Cache shared by the whole calculator, one per width.
+  static FixedMontCache &shared()
+  {
+    static FixedMontCache cache(256);
+    return cache;
+  }
+};
+
+#endif
@@ -0,0 +1,219 @@
+#ifndef GROUP_POOL_H
+#define GROUP_POOL_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "cryptopp/osrng.h"
+#include "json.hpp"
+#include "dh_group.h"
+
+// Keeps a bounded queue of validated safe prime groups for every
+// registered bit size. Background threads refill the queues so that
+// DataTxn does not have to search a safe prime while the client waits.
+class GroupPool
+{
+  struct Shelf
+  {
+    std::deque<DHGroup> groups;
+
+    // Number of groups that workers are currently searching for this shelf.
+    size_t in_flight = 0;
+
+    size_t generated = 0;
+    size_t rejected = 0;
+    size_t hits = 0;
+    size_t misses = 0;
+
+    // Total time that workers spent generating groups for this shelf.
+    double busy_sec = 0;
+
+    // Candidates that survived each stage of the safe prime searches
+    SieveCounts sieve;
+  };
+
+  std::map<unsigned int, Shelf> shelves;
+  size_t capacity;
+
+  // Threads used to search a group inline when a shelf is empty
+  unsigned int inline_threads;
+
+  uint32_t sieve_bound;
+
+  std::mutex m;
+  std::condition_variable need_refill;
+  std::vector<std::thread> workers;
+  bool stopping = false;
+
+  std::chrono::steady_clock::time_point started;
+
+  // Picks the shelf that is missing the most groups. Returns false when
+  // every shelf is full (counting groups that are being generated).
+  bool pick_shelf(unsigned int &bit_size)
+  {
+    size_t best_fill = capacity;
+    bool picked = false;
+
+    for (auto &kv : shelves) {
+      size_t fill = kv.second.groups.size() + kv.second.in_flight;
+      if (fill < best_fill) {
+        best_fill = fill;
+        bit_size = kv.first;
+        picked = true;
+      }
+    }
+    return picked;
+  }
+
+  void refill_loop()
+  {
+    CryptoPP::AutoSeededRandomPool rnd;
+
+    while (true) {
+      unsigned int bit_size = 0;
+      {
+        std::unique_lock<std::mutex> lock(m);
+        need_refill.wait(lock, [&] { return stopping || pick_shelf(bit_size); });
+        if (stopping) {
+          return;
+        }
+        shelves[bit_size].in_flight++;
+      }
+
+      auto begin = std::chrono::steady_clock::now();
+      SieveCounts counts;
+      DHGroup group = generate_group(bit_size, 1, &counts, sieve_bound);
+      bool valid = validate_group(rnd, group);
+      std::chrono::duration<double> took = std::chrono::steady_clock::now() - begin;
+
+      std::lock_guard<std::mutex> lock(m);
+      Shelf &shelf = shelves[bit_size];
+      shelf.in_flight--;
+      shelf.busy_sec += took.count();
+      shelf.sieve += counts;
+
+      if (valid) {
+        shelf.groups.push_back(group);
+        shelf.generated++;
+      }
+      else {
+        shelf.rejected++;
+      }
+    }
+  }
+
+  public:
+  GroupPool(const std::vector<unsigned int> &bit_sizes, size_t capacity,
+      unsigned int num_threads, unsigned int inline_threads,
+      uint32_t sieve_bound = SafePrimeSearch::DEFAULT_SIEVE_BOUND)
+    : capacity(capacity), inline_threads(inline_threads), sieve_bound(sieve_bound),
+      started(std::chrono::steady_clock::now())
+  {
+    for (unsigned int bit_size : bit_sizes) {
+      shelves[bit_size];
+    }
+
+    for (unsigned int i = 0; i < num_threads; i++) {
+      workers.emplace_back(&GroupPool::refill_loop, this);
+    }
+  }
+
+  ~GroupPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m);
+      stopping = true;
+    }
+    need_refill.notify_all();
+
+    for (auto &worker : workers) {
+      worker.join();
+    }
+  }
+
+  GroupPool(const GroupPool &) = delete;
+  GroupPool &operator=(const GroupPool &) = delete;
+
+  // Takes a group of the given size out of the pool. Only when the pool
+  // has nothing to give the group is generated inline.
+  //
+  // Only the sizes the pool was made with have a shelf. Clients choose
+  // the size, so any other one is generated inline every time instead of
+  // getting a shelf that the workers would keep filled from then on.
+  DHGroup take(unsigned int bit_size)
+  {
+    {
+      std::lock_guard<std::mutex> lock(m);
+      auto it = shelves.find(bit_size);
+
+      if (it != shelves.end()) {
+        Shelf &shelf = it->second;
+        if (!shelf.groups.empty()) {
+          DHGroup group = shelf.groups.front();
+          shelf.groups.pop_front();
+          shelf.hits++;
+
+          std::cout << "Group pool (" << bit_size << ") :: "
+            << shelf.groups.size() << "/" << capacity << std::endl;
+
+          need_refill.notify_one();
+          return group;
+        }
+        shelf.misses++;
+        need_refill.notify_one();
+      }
+    }
+
+    std::cout << "Group pool (" << bit_size << ") is empty; generating inline" << std::endl;
+
+    SieveCounts counts;
+    DHGroup group = generate_group(bit_size, inline_threads, &counts, sieve_bound);
+
+    std::lock_guard<std::mutex> lock(m);
+    auto it = shelves.find(bit_size);
+    if (it != shelves.end()) {
+      it->second.sieve += counts;
+    }
+    return group;
+  }
+
+  // Fill level and refill rate of every shelf.
+  nlohmann::json status()
+  {
+    std::lock_guard<std::mutex> lock(m);
+    std::chrono::duration<double> uptime = std::chrono::steady_clock::now() - started;
+
+    nlohmann::json result = nlohmann::json::array();
+    for (auto &kv : shelves) {
+      const Shelf &shelf = kv.second;
+
+      // Groups produced per minute since the pool has started, and the
+      // average time a single worker takes to produce one group.
+      double refill_per_min = uptime.count() > 0 ? shelf.generated * 60.0 / uptime.count() : 0;
+      double sec_per_group = shelf.generated > 0 ? shelf.busy_sec / shelf.generated : 0;
+
+      result.push_back({
+          {"bit_size", kv.first},
+          {"available", shelf.groups.size()},
+          {"capacity", capacity},
+          {"in_flight", shelf.in_flight},
+          {"generated", shelf.generated},
+          {"rejected", shelf.rejected},
+          {"hits", shelf.hits},
+          {"misses", shelf.misses},
+          {"refill_per_min", refill_per_min},
+          {"sec_per_group", sec_per_group},
+          {"sieve_bound", sieve_bound},
+          {"sieve", shelf.sieve.to_json()}});
+    }
+    return result;
+  }
+};
+
+#endif
@@ -0,0 +1,196 @@
+#ifndef GROUP_STORE_H
+#define GROUP_STORE_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cryptopp/cryptlib.h"
+#include "cryptopp/integer.h"
+#include "json.hpp"
+#include "dh_group.h"
+
+// On-disk layout of a group store (written by dh-param, read by main).
+//
+//   GroupStoreHeader
+//   GroupStoreRecord + p + q + g   (count times)
+//
+// p, q and g are unsigned big endian integers, each padded to field_len
+// bytes so that every record has the same size and can be found by index.
+struct GroupStoreHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t bit_size;
+  uint32_t count;
+  uint32_t field_len;
+};
+
+struct GroupStoreRecord
+{
+  uint32_t bit_count;
+  uint32_t reserved;
+};
+
+static const char GROUP_STORE_MAGIC[8] = {'D', 'H', 'G', 'S', 'T', 'O', 'R', 'E'};
+static const uint32_t GROUP_STORE_VERSION = 1;
+
+inline size_t group_store_record_size(uint32_t field_len)
+{
+  return sizeof(GroupStoreRecord) + 3 * (size_t)field_len;
+}
+
+// Writes already validated groups of the same size to path.
+// The file is written next to path first and then renamed, so a reader
+// never maps a half written store.
+inline void write_group_store(const std::string &path, unsigned int bit_size, const std::vector<DHGroup> &groups)
+{
+  GroupStoreHeader header;
+  memcpy(header.magic, GROUP_STORE_MAGIC, sizeof(header.magic));
+  header.version = GROUP_STORE_VERSION;
+  header.bit_size = bit_size;
+  header.count = groups.size();
+  header.field_len = (bit_size + 7) / 8;
+
+  std::string tmp_path = path + ".tmp";
+  FILE *fp = fopen(tmp_path.c_str(), "wb");
+  if (fp == nullptr) {
+    throw std::runtime_error("Failed to open " + tmp_path);
+  }
+
+  bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+  std::vector<CryptoPP::byte> record(group_store_record_size(header.field_len));
+
+  for (size_t i = 0; ok && i < groups.size(); i++) {
+    const DHGroup &group = groups[i];
+    if (group.p.BitCount() > bit_size) {
+      fclose(fp);
+      throw std::runtime_error("Group does not fit in the store");
+    }
+
+    GroupStoreRecord rec;
+    rec.bit_count = group.p.BitCount();
+    rec.reserved = 0;
+
+    CryptoPP::byte *field = record.data() + sizeof(rec);
+    memcpy(record.data(), &rec, sizeof(rec));
+    group.p.Encode(field, header.field_len);
+    group.q.Encode(field + header.field_len, header.field_len);
+    group.g.Encode(field + 2 * header.field_len, header.field_len);
+
+    ok = fwrite(record.data(), record.size(), 1, fp) == 1;
+  }
+
+  ok = (fclose(fp) == 0) && ok;
+  if (!ok || rename(tmp_path.c_str(), path.c_str()) != 0) {
+    throw std::runtime_error("Failed to write " + path);
+  }
+}
+
+// Read only view of a group store. The file is mmap'ed once at startup
+// and groups are drawn from it by decoding the fixed size records; the
+// groups were validated by dh-param when the store was written.
+class GroupStore
+{
+  std::string path;
+  const CryptoPP::byte *base = nullptr;
+  size_t length = 0;
+  GroupStoreHeader header;
+
+  // Every group is handed out at most once per process. The first index
+  // is picked at random so that restarts do not replay the same groups.
+  size_t first = 0;
+  std::atomic<size_t> drawn;
+
+  public:
+  GroupStore(const std::string &path, CryptoPP::RandomNumberGenerator &rnd)
+    : path(path), drawn(0)
+  {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::runtime_error("Failed to open group store " + path);
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(GroupStoreHeader)) {
+      close(fd);
+      throw std::runtime_error("Invalid group store " + path);
+    }
+    length = st.st_size;
+
+    void *mapped = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+      throw std::runtime_error("Failed to mmap group store " + path);
+    }
+    base = static_cast<const CryptoPP::byte *>(mapped);
+
+    memcpy(&header, base, sizeof(header));
+    if (memcmp(header.magic, GROUP_STORE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != GROUP_STORE_VERSION ||
+        header.field_len != (header.bit_size + 7) / 8 ||
+        length != sizeof(header) + header.count * group_store_record_size(header.field_len)) {
+      munmap(const_cast<CryptoPP::byte *>(base), length);
+      throw std::runtime_error("Corrupted group store " + path);
+    }
+
+    if (header.count > 0) {
+      first = rnd.GenerateWord32(0, header.count - 1);
+    }
+  }
+
+  ~GroupStore()
+  {
+    munmap(const_cast<CryptoPP::byte *>(base), length);
+  }
+
+  GroupStore(const GroupStore &) = delete;
+  GroupStore &operator=(const GroupStore &) = delete;
+
+  unsigned int bit_size() const { return header.bit_size; }
+
+  size_t remaining() const
+  {
+    size_t n = drawn.load();
+    return n < header.count ? header.count - n : 0;
+  }
+
+  // Returns false once every group of the store has been drawn.
+  bool take(DHGroup &group)
+  {
+    size_t n = drawn.fetch_add(1);
+    if (n >= header.count) {
+      return false;
+    }
+
+    size_t index = (first + n) % header.count;
+    const CryptoPP::byte *record = base + sizeof(header) + index * group_store_record_size(header.field_len);
+    const CryptoPP::byte *field = record + sizeof(GroupStoreRecord);
+
+    group.p.Decode(field, header.field_len);
+    group.q.Decode(field + header.field_len, header.field_len);
+    group.g.Decode(field + 2 * header.field_len, header.field_len);
+    return true;
+  }
+
+  nlohmann::json status() const
+  {
+    return {
+      {"path", path},
+      {"bit_size", header.bit_size},
+      {"count", header.count},
+      {"remaining", remaining()}
+    };
+  }
+};
+
+#endif
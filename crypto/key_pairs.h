@@ -0,0 +1,78 @@
+#ifndef KEY_PAIRS_H
+#define KEY_PAIRS_H
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "cryptopp/integer.h"
+
+#include "dh_group.h"
+#include "exponent_pool.h"
+#include "fixed_base.h"
+#include "simd_modexp.h"
+#include "thread_pool.h"
+
+// Fills priv and pub with key pairs (x, g^x) of the group, x in
+// [1, max_priv], e.g. the a, r and K tryouts of a DATA TXN.
+//
+// Pairs are popped from the exponent pool when it has them. The others
+// are spread over the workers of pool, each drawing its exponents from
+// its own thread_rng() and writing them to their slots, so the order of
+// the result does not depend on the scheduling. They are exponentiated
+// with the fixed-base table of the group if it is reused (so worth
+// building one) or already has one; the powers of a group used just once
+// are computed side by side in SIMD lanes instead, see simd_modexp.h.
+inline void create_key_pairs(ExponentPool &exponents, const std::string &pool_key,
+    const DHGroup &group, const CryptoPP::Integer &max_priv, bool reused,
+    std::vector<CryptoPP::Integer> &priv, std::vector<CryptoPP::Integer> &pub,
+    ThreadPool &pool = ThreadPool::shared())
+{
+  std::vector<size_t> missing;
+  for (size_t i = 0; i < priv.size(); i++) {
+    if (!exponents.take(pool_key, priv[i], pub[i])) {
+      missing.push_back(i);
+    }
+  }
+  if (missing.empty()) {
+    return;
+  }
+
+  auto base = reused ? FixedBaseCache::shared().table(group.p, group.g)
+    : FixedBaseCache::shared().find(group.p, group.g);
+
+  // Chunks of whole SIMD batches, at most one per thread
+  const size_t lanes = base ? 1 : simd_mont(simd_kernel()).lanes;
+  const size_t batches = (missing.size() + lanes - 1) / lanes;
+  const size_t chunks = std::min(batches, pool.size() + 1);
+
+  pool.parallel_for(chunks, [&](size_t c) {
+    const size_t begin = std::min(missing.size(), batches * c / chunks * lanes);
+    const size_t end = std::min(missing.size(), batches * (c + 1) / chunks * lanes);
+
+    CryptoPP::AutoSeededRandomPool &rnd = thread_rng();
+    for (size_t k = begin; k < end; k++) {
+      priv[missing[k]] = CryptoPP::Integer(rnd, CryptoPP::Integer::One(), max_priv);
+    }
+
+    if (base) {
+      for (size_t k = begin; k < end; k++) {
+        pub[missing[k]] = base->exponentiate(priv[missing[k]]);
+      }
+      return;
+    }
+
+    std::vector<CryptoPP::Integer> bases(end - begin, group.g);
+    std::vector<CryptoPP::Integer> exps;
+    for (size_t k = begin; k < end; k++) {
+      exps.push_back(priv[missing[k]]);
+    }
+
+    std::vector<CryptoPP::Integer> powers = simd_exponentiate(group.p, bases, exps);
+    for (size_t k = begin; k < end; k++) {
+      pub[missing[k]] = powers[k - begin];
+    }
+  });
+}
+
+#endif
@@ -0,0 +1,187 @@
+#ifndef LANE_SCHEDULER_H
+#define LANE_SCHEDULER_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "json.hpp"
+
+// A lane of LaneScheduler: its own queue, the workers reserved for it and
+// its priority (higher goes first).
+struct LaneConfig
+{
+  std::string name;
+  int priority;
+  unsigned int reserved;
+};
+
+// Workers for jobs of very different cost, e.g. a DATA TXN (a group and
+// an RSA key, up to seconds) next to an ANSWER TXN (a modexp). Each lane
+// has its own queue and its reserved workers, which serve nothing else
+// while the lane has work; the shared workers serve every lane by
+// priority.
+//
+// An idle reserved worker steals from the lanes of higher priority than
+// its own, never from lower ones: a burst of cheap, urgent jobs can borrow
+// the workers of a slow lane, but a slow lane cannot tie up the workers
+// reserved for the urgent ones, so their latency does not depend on how
+// much slow work is queued.
+class LaneScheduler
+{
+  struct Lane
+  {
+    LaneConfig config;
+    std::deque<std::function<void()>> jobs;
+    size_t running = 0;
+    size_t done = 0;
+    size_t borrowed = 0;
+  };
+
+  std::vector<Lane> lanes;
+
+  // Lane indices, highest priority first
+  std::vector<size_t> by_priority;
+
+  std::vector<std::thread> workers;
+
+  std::mutex m;
+  std::condition_variable has_job;
+  bool stopping = false;
+
+  // Lane the worker of the home lane takes its next job from
+  bool pick(size_t home, size_t &lane)
+  {
+    if (home != SHARED && !lanes[home].jobs.empty()) {
+      lane = home;
+      return true;
+    }
+
+    for (size_t l : by_priority) {
+      if (home != SHARED && lanes[l].config.priority <= lanes[home].config.priority) {
+        break;
+      }
+      if (!lanes[l].jobs.empty()) {
+        lane = l;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void work_loop(size_t home)
+  {
+    while (true) {
+      std::function<void()> job;
+      size_t lane = 0;
+      {
+        std::unique_lock<std::mutex> lock(m);
+        has_job.wait(lock, [&] { return stopping || pick(home, lane); });
+        if (stopping) {
+          return;
+        }
+
+        job = std::move(lanes[lane].jobs.front());
+        lanes[lane].jobs.pop_front();
+        lanes[lane].running++;
+        if (home != SHARED && lane != home) {
+          lanes[lane].borrowed++;
+        }
+      }
+
+      // Jobs reply with their own errors; whatever escapes is logged
+      // rather than taking the worker down.
+      try {
+        job();
+      }
+      catch (std::exception &e) {
+        std::cout << "Error :: job of lane " << lanes[lane].config.name << " :: " << e.what() << std::endl;
+      }
+      catch (...) {
+        std::cout << "Error :: job of lane " << lanes[lane].config.name << " failed" << std::endl;
+      }
+
+      std::lock_guard<std::mutex> lock(m);
+      lanes[lane].running--;
+      lanes[lane].done++;
+    }
+  }
+
+  public:
+  // Home of the workers that are reserved for no lane
+  static const size_t SHARED = (size_t)-1;
+
+  LaneScheduler(const std::vector<LaneConfig> &configs, unsigned int shared_workers)
+  {
+    for (auto &config : configs) {
+      lanes.emplace_back();
+      lanes.back().config = config;
+      by_priority.push_back(by_priority.size());
+    }
+    std::stable_sort(by_priority.begin(), by_priority.end(), [&](size_t a, size_t b) {
+      return lanes[a].config.priority > lanes[b].config.priority;
+    });
+
+    for (size_t l = 0; l < lanes.size(); l++) {
+      for (unsigned int i = 0; i < lanes[l].config.reserved; i++) {
+        workers.emplace_back(&LaneScheduler::work_loop, this, l);
+      }
+    }
+    for (unsigned int i = 0; i < shared_workers; i++) {
+      workers.emplace_back(&LaneScheduler::work_loop, this, SHARED);
+    }
+  }
+
+  ~LaneScheduler()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m);
+      stopping = true;
+    }
+    has_job.notify_all();
+
+    for (auto &worker : workers) {
+      worker.join();
+    }
+  }
+
+  LaneScheduler(const LaneScheduler &) = delete;
+  LaneScheduler &operator=(const LaneScheduler &) = delete;
+
+  size_t size() const { return workers.size(); }
+
+  void submit(size_t lane, std::function<void()> job)
+  {
+    {
+      std::lock_guard<std::mutex> lock(m);
+      lanes.at(lane).jobs.push_back(std::move(job));
+    }
+    // Not every worker may take from the lane, so wake them all
+    has_job.notify_all();
+  }
+
+  nlohmann::json status()
+  {
+    std::lock_guard<std::mutex> lock(m);
+    nlohmann::json j = nlohmann::json::object();
+    for (auto &lane : lanes) {
+      j[lane.config.name] = {
+        {"priority", lane.config.priority},
+        {"reserved", lane.config.reserved},
+        {"queued", lane.jobs.size()},
+        {"running", lane.running},
+        {"done", lane.done},
+        {"borrowed", lane.borrowed}
+      };
+    }
+    return j;
+  }
+};
+
+#endif
@@ -1,4 +1,4 @@
-// g++ main.cpp -o main -lzmq ./libcryptopp.a -std=c++11
+// g++ main.cpp -o main -lzmq ./libcryptopp.a -std=c++11 -lpthread
 
 #include <zmq.hpp>
 #include <string>
@@ -7,6 +7,13 @@
 #include <vector>
 #include <sstream>
 #include <bitset>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include "cryptopp/osrng.h"
 #include "cryptopp/integer.h"
 #include "cryptopp/nbtheory.h"
@@ -20,6 +27,26 @@
 // For our JSON support
 #include "json.hpp"
 
+#include "dh_group.h"
+#include "group_pool.h"
+#include "group_store.h"
+#include "named_groups.h"
+#include "txn_profile.h"
+#include "rsa_pair.h"
+#include "rsa_pool.h"
+#include "exponent_pool.h"
+#include "fixed_base.h"
+#include "montgomery.h"
+#include "zkp_verify.h"
+#include "simd_modexp.h"
+#include "fixed_int.h"
+#include "fiat_shamir.h"
+#include "challenge.h"
+#include "key_pairs.h"
+#include "shared_secret_cache.h"
+#include "lane_scheduler.h"
+#include "wire_format.h"
+
 using json = nlohmann::json;
 using CryptoPP::AutoSeededRandomPool;
 using CryptoPP::Integer;
@@ -32,111 +59,30 @@ using std::cout;
 using std::stringstream;
 using std::string;
 
-struct RSAPair
+// g^{priv} == pub mod G, where base holds the powers of g.
+// priv is drawn from the same range as DH::GenerateKeyPair does.
+void create_key_pair(AutoSeededRandomPool &rnd, DH &dh, const FixedBaseTable *base,
+    const MontgomeryContext &mont, Integer &priv, Integer &pub)
 {
-  string str_prv;
-  string str_pub;
-
-  public:
-  RSAPair(int key_size)
-  {
-    CryptoPP::InvertibleRSAFunction rsa;
-    AutoSeededRandomPool rnd;
-
-    rsa.GenerateRandomWithKeySize(rnd, key_size);
-    RSA::PrivateKey priv(rsa);
-    RSA::PublicKey pub(rsa);
-
-    CryptoPP::StringSink fs(str_prv);
-    CryptoPP::PEM_Save(fs, priv);
-
-    CryptoPP::StringSink fs2(str_pub);
-    CryptoPP::PEM_Save(fs2, pub);
-
-    // Remove trailing newline character
-    if (str_pub[str_pub.length() - 1] == '\n') {
-      str_pub.erase(str_pub.length() - 1);
-    }
-    if (str_prv[str_prv.length() - 1] == '\n') {
-      str_prv.erase(str_prv.length() - 1);
-    }
-  }
-
-  std::vector<string> encrypt(std::vector<string> msgs)
-  {
-    AutoSeededRandomPool rnd;
-    CryptoPP::InvertibleRSAFunction rsa;
-
-    RSA::PrivateKey priv (rsa);
-    RSA::PublicKey pub(rsa);
-
-    CryptoPP::StringSink fs(str_prv);
-    CryptoPP::PEM_Load(fs, priv);
-
-    CryptoPP::StringSink fs2(str_pub);
-    CryptoPP::PEM_Load(fs2, pub);
-
-    CryptoPP::RSAES_OAEP_SHA_Encryptor encryptor(pub);
-    std::vector<string> cipher_list;
-
-
-    for (unsigned int i = 0; i < msgs.size(); i ++) {
-      string cipher;
-      CryptoPP::StringSource ss1(msgs[i], true,
-          new CryptoPP::PK_EncryptorFilter(rnd, encryptor,
-            new CryptoPP::StringSink(cipher)
-            )
-          );
-      cipher_list.push_back(cipher);
-    }
-
-    return cipher_list;
-  }
-};
-
-// g^{priv} == pub mod G
-void create_key_pair(AutoSeededRandomPool &rnd, DH &dh, Integer &priv, Integer &pub)
-{
-  SecByteBlock block_priv(dh.PrivateKeyLength());
-  SecByteBlock block_pub(dh.PublicKeyLength());
-
-  dh.GenerateKeyPair(rnd, block_priv, block_pub);
-  priv.Decode(block_priv, dh.PrivateKeyLength());
-  pub.Decode(block_pub, dh.PublicKeyLength());
+  priv = Integer(rnd, Integer::One(), dh.GetGroupParameters().GetMaxExponent());
+  pub = base ? base->exponentiate(priv)
+    : mont.exponentiate(dh.GetGroupParameters().GetGenerator(), priv);
 
   return;
 }
 
-// convert Integer object to string (in hex format!)
-string integer_to_string(Integer num)
+// Same, but pops a pair precomputed by the pool when the group has one
+void create_key_pair(ExponentPool &exponents, const string &pool_key,
+    AutoSeededRandomPool &rnd, DH &dh, const FixedBaseTable *base,
+    const MontgomeryContext &mont, Integer &priv, Integer &pub)
 {
-  stringstream ss;
-
-  ss << std::hex << num;
-
-  string s = ss.str();
-
-  // std::hex prints the number in HEX but it appends 'h'
-  // at the end of the string
-  if (s[s.length() - 1] == 'h')
-  {
-    s.erase(s.begin() + s.length() - 1);
+  if (!exponents.take(pool_key, priv, pub)) {
+    create_key_pair(rnd, dh, base, mont, priv, pub);
   }
-
-  return s;
 }
 
 class DataTxn
 {
-  Integer integer_with_hex(string hex)
-  {
-    // Insert '0x' at front
-    hex.insert(0, "0x");
-
-    return Integer(hex.c_str());
-  }
-
-
   std::vector<string> str_g_r_i;
   std::vector<string> str_r_i;
   string str_G;
@@ -148,43 +94,60 @@ class DataTxn
   string str_secret;
   int K;
 
+  // Id of the named group (see named_groups.h) or empty when
+  // the group was freshly generated.
+  string group_id;
+
+  // Named groups are only referred by their id; otherwise
+  // the txn has to carry the whole G and g.
+  void put_group(json &j)
+  {
+    if (group_id.empty()) {
+      j["G"] = wire_integer(str_G);
+      j["g"] = wire_integer(str_g);
+    }
+    else {
+      j["group"] = group_id;
+    }
+  }
+
   public:
   // Create a data txn with given info.
-  DataTxn(int bit_size, int K, string hashed_identity)
-    : K(K)
+  // The group is the safe prime G (in form of 2q + 1 where q is
+  // an another prime) and its generator g, see GroupPool.
+  // Key pairs of reused groups come from exponents, see ExponentPool.
+  DataTxn(ExponentPool &exponents, const DHGroup &group, int K,
+      string hashed_identity, string group_id = "")
+    : K(K), group_id(group_id)
   {
-    AutoSeededRandomPool rnd;
     DH dh;
+    dh.AccessGroupParameters().Initialize(group.p, group.q, group.g);
 
-    // Generates safe prime G and its generator g.
-    // "Safe prime" for DH structure is the prime p that is in form
-    // 2q + 1 where q is an another prime.
-    dh.AccessGroupParameters().GenerateRandomWithKeySize(rnd, bit_size);
+    string pool_key = exponents.use(group, !group_id.empty());
 
     // Get G and g
     const Integer &G = dh.GetGroupParameters().GetModulus();
     const Integer &g = dh.GetGroupParameters().GetGenerator();
 
-    // Key pairs for DH communication with Request TXN
-    Integer g_a, a;
-    create_key_pair(rnd, dh, a, g_a);
+    // Key pairs for DH communication with Request TXN (a), for
+    // encrypting secret key (r) and the 'tryouts' for ZKP (r_i)
+    std::vector<Integer> priv(K + 2), pub(K + 2);
+    create_key_pairs(exponents, pool_key, group, dh.GetGroupParameters().GetMaxExponent(),
+        !group_id.empty(), priv, pub);
 
-    // For encrypting secret key
-    Integer r, g_r;
-    create_key_pair(rnd, dh, r, g_r);
+    const Integer &a = priv[0], &g_a = pub[0];
+    const Integer &r = priv[1], &g_r = pub[1];
 
     // Create secret secret = g^r + hashed_identity
-    Integer secret = g_r + integer_with_hex(hashed_identity);
+    Integer secret = g_r + integer_from_string(hashed_identity);
 
-    // Create 'tryouts' for ZKP
-    for (int i = 0; i < K; i++)
-    {
-      Integer zkp_r, zkp_g_r;
-      create_key_pair(rnd, dh, zkp_r, zkp_g_r);
-
-      str_r_i.push_back(integer_to_string(zkp_r));
-      str_g_r_i.push_back(integer_to_string(zkp_g_r));
-    }
+    // Create 'tryouts' for ZKP, each into its own slot
+    str_r_i.resize(K);
+    str_g_r_i.resize(K);
+    ThreadPool::shared().parallel_for(K, [&](size_t i) {
+      str_r_i[i] = integer_to_string(priv[i + 2]);
+      str_g_r_i[i] = integer_to_string(pub[i + 2]);
+    });
 
     str_G = integer_to_string(G);
     str_g = integer_to_string(g);
@@ -195,76 +158,69 @@ class DataTxn
     str_secret = integer_to_string(secret);
   }
 
-  string serialize_data(string token)
+  // pair is the newly generated key of the user, see RSAKeyPool.
+  json serialize_data(string token, const RSAPair &pair)
   {
-    cout << "Finding RSA pairs ... " << std::endl;
-    RSAPair pair(2048);
 
     json j = {
-      {"G", str_G},
-      {"g", str_g},
-      {"r", str_r},
-      {"g_r", str_g_r},
-      {"a", str_a},
-      {"g_a", str_g_a},
-      {"secret", str_secret},
-      {"g_r_i", str_g_r_i},
-      {"r_i", str_r_i},
+      {"r", wire_integer(str_r)},
+      {"g_r", wire_integer(str_g_r)},
+      {"a", wire_integer(str_a)},
+      {"g_a", wire_integer(str_g_a)},
+      {"secret", wire_integer(str_secret)},
+      {"g_r_i", wire_integers(str_g_r_i)},
+      {"r_i", wire_integers(str_r_i)},
       {"pub_key", pair.str_pub},
       {"prv_key", pair.str_prv},
       {"K", K},
       {"token", token}};
+    put_group(j);
 
-    cout << j << std::endl;
-    // Return the serialized JSON object
-    return j.dump();
+    cout << encode_reply(WireFormat::JSON, j) << std::endl;
+    return j;
   }
 
   // If it is supplied with RSA private key, 
-  string serialize_data_without_rsa_key(string token) 
+  json serialize_data_without_rsa_key(string token) 
   {
     json j = {
-      {"G", str_G},
-      {"g", str_g},
-      {"r", str_r},
-      {"g_r", str_g_r},
-      {"a", str_a},
-      {"g_a", str_g_a},
-      {"secret", str_secret},
-      {"g_r_i", str_g_r_i},
-      {"r_i", str_r_i},
+      {"r", wire_integer(str_r)},
+      {"g_r", wire_integer(str_g_r)},
+      {"a", wire_integer(str_a)},
+      {"g_a", wire_integer(str_g_a)},
+      {"secret", wire_integer(str_secret)},
+      {"g_r_i", wire_integers(str_g_r_i)},
+      {"r_i", wire_integers(str_r_i)},
       {"K", K},
       {"token", token}};
+    put_group(j);
 
-    cout << j << std::endl;
-    // Return the serialized JSON object
-    return j.dump();
+    cout << encode_reply(WireFormat::JSON, j) << std::endl;
+    return j;
   }
 };
 
 class RequestTxn
 {
-  Integer integer_with_hex(string hex)
-  {
-    // Insert '0x' at front
-    hex.insert(0, "0x");
-
-    return Integer(hex.c_str());
-  }
-
   string str_b;
   string str_g_b;
   string str_g_g_ab_p_r;
-  string req_str;
+  Challenge challenge;
+  bool fiat_shamir;
 
   public:
-  RequestTxn(string str_G, string str_g, string str_g_a, string str_secret, int K, string hashed_request_identity)
+  // With fiat_shamir (the commitments of the data txn) the challenge is
+  // derived from them instead of drawn at random, see fiat_shamir.h.
+  RequestTxn(ExponentPool &exponents, string str_G, string str_g, string str_g_a,
+      string str_secret, int K, string hashed_request_identity,
+      const FiatShamirContext *fiat_shamir = nullptr)
+    : fiat_shamir(fiat_shamir != nullptr)
   {
 
-    Integer G = integer_with_hex(str_G);
-    Integer g = integer_with_hex(str_g);
-    Integer g_a = integer_with_hex(str_g_a);
-    Integer secret = integer_with_hex(str_secret);
+    Integer G = integer_from_string(str_G);
+    Integer g = integer_from_string(str_g);
+    Integer g_a = integer_from_string(str_g_a);
+    Integer secret = integer_from_string(str_secret);
 
     cout << "K :: " << K;
 
@@ -274,154 +230,464 @@ class RequestTxn
 
     // Generate b and g^b for request txn
     AutoSeededRandomPool rng;
-    Integer b, g_b;
-    create_key_pair(rng, dh_req, b, g_b);
-
-    // Calculate the shared secret g^ab
-    SecByteBlock shared (dh_req.AgreedValueLength());
-    SecByteBlock sec_b (dh_req.PrivateKeyLength()), sec_g_a(dh_req.PublicKeyLength());
-
-
-    b.Encode(sec_b, dh_req.PrivateKeyLength());
-    g_a.Encode(sec_g_a, dh_req.PublicKeyLength());
+    // Every request to the same data txn is made over its group
+    bool named = find_named_group(G, g) != nullptr;
+    string pool_key = exponents.use(DHGroup{G, G >> 1, g}, named);
 
-    dh_req.Agree(shared, sec_b, sec_g_a);
+    // Only a reused group is worth a fixed-base table (see key_pairs.h);
+    // a one-off group goes through its Montgomery context
+    auto base = exponents.reused(pool_key) ? FixedBaseCache::shared().table(G, g)
+      : FixedBaseCache::shared().find(G, g);
+    auto mont = MontgomeryCache::shared().context(G);
 
-    Integer g_ab;
-    g_ab.Decode(shared, dh_req.AgreedValueLength());
-
-    Integer identity_hash = integer_with_hex(hashed_request_identity);
-    Integer g_g_ab_p_r = ModularExponentiation(g, g_ab, G) * (secret - identity_hash);
-
-    req_str = "";
+    Integer b, g_b;
+    create_key_pair(exponents, pool_key, rng, dh_req, base.get(), *mont, b, g_b);
 
-    for (int i = 0; i < K; i ++) {
-      Integer req (rng, 1);
-      if (req == 1) {
-        req_str.push_back('1');
-      }
-      else {
-        req_str.push_back('0');
-      }
+    // Calculate the shared secret g^ab, with the same check of g^a
+    // as DH::Agree
+    if (g_a <= Integer::One() || g_a >= G) {
+      throw std::invalid_argument("invalid g_a");
     }
+    Integer g_ab = mont->exponentiate(g_a, b);
+    Integer g_g_ab = base ? base->exponentiate(g_ab) : mont->exponentiate(g, g_ab);
+
+    Integer identity_hash = integer_from_string(hashed_request_identity);
+    Integer g_g_ab_p_r = g_g_ab * (secret - identity_hash);
 
     str_b = integer_to_string(b);
 
     str_g_b = integer_to_string(g_b);
     str_g_g_ab_p_r = integer_to_string(g_g_ab_p_r);
+
+    if (fiat_shamir) {
+      challenge = Challenge::from_string(
+          fiat_shamir_challenge(*fiat_shamir, str_g_b, str_g_g_ab_p_r));
+      return;
+    }
+
+    challenge = Challenge::random(rng, K);
   }
 
-  string serialize_data(string token)
+  json serialize_data(string token)
   {
     json j = {
-      {"g_b", str_g_b},
-      {"g_g_ab_p_r", str_g_g_ab_p_r},
-      {"req", req_str},
-      {"b", str_b},
+      {"g_b", wire_integer(str_g_b)},
+      {"g_g_ab_p_r", wire_integer(str_g_g_ab_p_r)},
+      {"req", challenge.to_string()},
+      {"req_bits", challenge.to_hex()},
+      {"b", wire_integer(str_b)},
       {"token", token}
     };
+    if (fiat_shamir) {
+      j["fiat_shamir"] = 1;
+    }
 
-    cout << j << std::endl;
-    return j.dump();
+    cout << encode_reply(WireFormat::JSON, j) << std::endl;
+    return j;
   }
 };
 
 class AnswerTxn
 {
+  // Response to each request, in order
+  std::vector<std::vector<string>> responses;
+
+  // Tryouts that a '1' of any of the requests reveals, the only r_i that
+  // have to be parsed
+  static std::vector<size_t> revealed(const std::vector<string> &requests, size_t K)
+  {
+    std::vector<size_t> indices;
+    for (size_t i = 0; i < K; i++) {
+      for (auto &request : requests) {
+        if (i < request.size() && request[i] == '1') {
+          indices.push_back(i);
+          break;
+        }
+      }
+    }
+    return indices;
+  }
 
-  Integer integer_with_hex(string hex)
+  // g_b^a mod G, out of SharedSecretCache when it was computed lately
+  template <size_t Bits>
+  static FixedInt<Bits> shared_secret(const FixedMont<Bits> &mont, const string &key,
+      const FixedInt<Bits> &g_b, const FixedInt<Bits> &a)
   {
-    // Insert '0x' at front
-    hex.insert(0, "0x");
+    FixedInt<Bits> g_ab;
+    SecByteBlock bytes;
+    if (SharedSecretCache::shared().find(key, bytes) &&
+        FixedInt<Bits>::from_bytes(bytes.BytePtr(), bytes.size(), g_ab)) {
+      return g_ab;
+    }
 
-    return Integer(hex.c_str());
+    g_ab = mont.exponentiate(g_b, a);
+    bytes.CleanNew(Bits / 8);
+    g_ab.to_bytes(bytes.BytePtr());
+    SharedSecretCache::shared().insert(key, bytes.BytePtr(), bytes.size());
+    return g_ab;
   }
 
-  std::vector<string> response;
+  Integer shared_secret(const MontgomeryContext &mont, const string &key,
+      const string &str_g_b, const Integer &a)
+  {
+    Integer g_ab;
+    SecByteBlock bytes;
+    if (SharedSecretCache::shared().find(key, bytes)) {
+      g_ab.Decode(bytes.BytePtr(), bytes.size());
+      return g_ab;
+    }
 
-  public:
+    g_ab = mont.exponentiate(integer_from_string(str_g_b), a);
+    bytes.CleanNew(g_ab.MinEncodedSize());
+    g_ab.Encode(bytes.BytePtr(), bytes.size());
+    SharedSecretCache::shared().insert(key, bytes.BytePtr(), bytes.size());
+    return g_ab;
+  }
 
-  AnswerTxn(string str_G, string str_g, string str_g_b, std::vector<string> r_i_list, string str_r, string str_a, string request) {
+  // Same as the Integer path of the constructor on FixedInt, when G is
+  // exactly Bits wide, so that no temporary of the answer touches the heap.
+  // Returns false (and leaves responses empty) for any other G.
+  template <size_t Bits>
+  bool answer_fixed(const string &str_G, const std::vector<string> &g_bs,
+      const std::vector<string> &r_i_list, const string &str_r, const string &str_a,
+      const std::vector<string> &requests)
+  {
+    FixedInt<Bits> G, a;
+    FixedInt<Bits + 64> r;
+    if (!FixedInt<Bits>::from_hex(str_G, G) || !G.top_bit() || !G.bit(0) ||
+        !FixedInt<Bits>::from_hex(str_a, a) || !FixedInt<Bits + 64>::from_hex(str_r, r)) {
+      return false;
+    }
 
-    Integer a = integer_with_hex(str_a);
-    Integer G = integer_with_hex(str_G);
-    Integer g = integer_with_hex(str_g);
+    std::vector<FixedInt<Bits>> g_b(g_bs.size());
+    for (size_t k = 0; k < g_bs.size(); k++) {
+      if (!FixedInt<Bits>::from_hex(g_bs[k], g_b[k]) || g_b[k].compare(G) >= 0) {
+        return false;
+      }
+    }
 
-    Integer g_b = integer_with_hex(str_g_b);
-    Integer g_ab = ModularExponentiation(g_b, a, G);
+    std::vector<FixedInt<Bits + 64>> r_i(r_i_list.size());
+    for (size_t i : revealed(requests, r_i_list.size())) {
+      if (!FixedInt<Bits + 64>::from_hex(r_i_list[i], r_i[i])) {
+        return false;
+      }
+    }
 
-    Integer r = integer_with_hex(str_r);
+    // Named groups have their constants ready, other moduli are set up
+    // once and cached
+    const FixedMont<Bits> *mont = named_fixed_mont(G);
+    std::shared_ptr<const FixedMont<Bits>> cached;
+    if (mont == nullptr) {
+      cached = FixedMontCache<Bits>::shared().mont(G);
+      mont = cached.get();
+    }
 
-    for (unsigned int i = 0; i < request.size(); i ++) {
-      if (request[i] == '0') {
-        response.push_back(r_i_list[i]);
+    std::vector<std::vector<string>> out(requests.size());
+    ThreadPool::shared().parallel_for(requests.size(), [&](size_t k) {
+      const string &request = requests[k];
+      FixedInt<Bits> g_ab = shared_secret(*mont, SharedSecretCache::key_of(str_G, g_bs[k], str_a), g_b[k], a);
+
+      // r + g_ab, the same for every '1'
+      FixedInt<Bits + 64> r_g_ab = g_ab.template resize<Bits + 64>();
+      r_g_ab.add(r);
+
+      for (unsigned int i = 0; i < request.size(); i ++) {
+        if (request[i] == '0') {
+          out[k].push_back(r_i_list[i]);
+        }
+        else if (request[i] == '1') {
+          FixedInt<Bits + 64> resp = r_i[i];
+          resp.add(r_g_ab);
+          out[k].push_back(resp.to_hex());
+        }
       }
-      else if (request[i] == '1') {
-        Integer r_i_num = integer_with_hex(r_i_list[i]);
-        Integer resp = r_i_num + r + g_ab;
-        response.push_back(integer_to_string(resp));
+    });
+
+    responses = std::move(out);
+    return true;
+  }
+
+  public:
+
+  AnswerTxn(string str_G, string str_g, string str_g_b, std::vector<string> r_i_list, string str_r, string str_a, string request)
+    : AnswerTxn(str_G, str_g, std::vector<string>{str_g_b}, r_i_list, str_r, str_a, std::vector<string>{request})
+  {
+  }
+
+  // Answers to any number of requests (g_bs[k], requests[k]) to the same
+  // data txn at once: a, r and the revealed r_i are parsed just once, and
+  // the requests are answered side by side on the shared pool.
+  AnswerTxn(string str_G, string str_g, const std::vector<string> &g_bs, std::vector<string> r_i_list,
+      string str_r, string str_a, const std::vector<string> &requests)
+  {
+    if (g_bs.size() != requests.size()) {
+      throw std::invalid_argument("g_b and req differ in number");
+    }
+    for (auto &request : requests) {
+      if (request.size() > r_i_list.size()) {
+        throw std::invalid_argument("req has more bits than r_i");
       }
     }
+
+    // A '0' echoes its r_i in the hex a '1' is written in, whatever the
+    // case and leading zeros it came with
+    for (auto &request : requests) {
+      for (size_t i = 0; i < request.size(); i++) {
+        if (request[i] == '0') {
+          r_i_list[i] = bytes_to_hex(hex_to_bytes(r_i_list[i]));
+        }
+      }
+    }
+
+    // Groups of the common sizes take the fixed width path
+    if (answer_fixed<1024>(str_G, g_bs, r_i_list, str_r, str_a, requests) ||
+        answer_fixed<2048>(str_G, g_bs, r_i_list, str_r, str_a, requests) ||
+        answer_fixed<3072>(str_G, g_bs, r_i_list, str_r, str_a, requests)) {
+      return;
+    }
+
+    Integer a = integer_from_string(str_a);
+    Integer G = integer_from_string(str_G);
+
+    Integer r = integer_from_string(str_r);
+
+    std::vector<Integer> r_i(r_i_list.size());
+    for (size_t i : revealed(requests, r_i_list.size())) {
+      r_i[i] = integer_from_string(r_i_list[i]);
+    }
+
+    auto mont = MontgomeryCache::shared().context(G);
+
+    responses.resize(requests.size());
+    ThreadPool::shared().parallel_for(requests.size(), [&](size_t k) {
+      const string &request = requests[k];
+      Integer g_ab = shared_secret(*mont, SharedSecretCache::key_of(str_G, g_bs[k], str_a), g_bs[k], a);
+      Integer r_g_ab = r + g_ab;
+
+      for (unsigned int i = 0; i < request.size(); i ++) {
+        if (request[i] == '0') {
+          responses[k].push_back(r_i_list[i]);
+        }
+        else if (request[i] == '1') {
+          Integer resp = r_i[i] + r_g_ab;
+          responses[k].push_back(integer_to_string(resp));
+        }
+      }
+    });
   }
 
-  string serialize_data(string token) {
+  // req is the challenge the answer was made for, when the caller did
+  // not know it beforehand (a non-interactive answer)
+  json serialize_data(string token, string req = "") {
     json j = {
-      {"response", response},
+      {"response", wire_integers(responses.at(0))},
       {"token", token}
     };
+    if (!req.empty()) {
+      j["req"] = req;
+    }
 
-    cout << j << std::endl;
-    return j.dump();
+    cout << encode_reply(WireFormat::JSON, j) << std::endl;
+    return j;
+  }
+
+  // Reply to a batch, one {response[, req]} per request in order; reqs as
+  // for serialize_data
+  json serialize_batch(string token, const std::vector<string> &reqs) {
+    json list = json::array();
+    for (size_t k = 0; k < responses.size(); k++) {
+      json item = {{"response", wire_integers(responses[k])}};
+      if (k < reqs.size() && !reqs[k].empty()) {
+        item["req"] = reqs[k];
+      }
+      list.push_back(item);
+    }
+
+    json j = {
+      {"responses", list},
+      {"token", token}
+    };
+
+    cout << encode_reply(WireFormat::JSON, j) << std::endl;
+    return j;
   }
 };
 
-int main()
+// Draws a group of given size from the group stores (made by dh-param)
+// first. Once they run out, the group pool takes over.
+DHGroup take_group(std::vector<std::unique_ptr<GroupStore>> &group_stores,
+    GroupPool &group_pool, unsigned int bit_size)
 {
-  //  Prepare our context and socket
-  zmq::context_t context(1);
-  zmq::socket_t socket(context, ZMQ_REP);
-  socket.bind("tcp://*:5555");
+  DHGroup group;
+  for (auto &store : group_stores) {
+    if (store->bit_size() == bit_size && store->take(group)) {
+      return group;
+    }
+  }
 
-  cout << "---------- TXN Calculator is started ---------------" << std::endl;
+  return group_pool.take(bit_size);
+}
 
-  while (true)
-  {
-    zmq::message_t request;
+// G and g (in hex) of a txn payload, which either has them or
+// only the id of a named group.
+void group_of_payload(const json &payload, string &G, string &g)
+{
+  if (payload.count("group")) {
+    string id = payload.at("group");
+    const NamedGroup *named = find_named_group(id);
+    if (named == nullptr) {
+      throw std::runtime_error("Unknown group " + id);
+    }
+
+    G = integer_to_string(named_group(*named).p);
+    g = integer_to_string(named_group(*named).g);
+    return;
+  }
+
+  G = payload.at("G").get<string>();
+  g = payload.at("g").get<string>();
+}
+
+// Challenge of a request payload as '0'/'1' string, out of "req" or else
+// the packed "req_bits" of a data txn with K tryouts
+string challenge_of_payload(const json &payload, size_t K)
+{
+  if (payload.count("req")) {
+    return payload.at("req");
+  }
+  return Challenge::from_hex(payload.at("req_bits"), K).to_string();
+}
+
+// Commitments of a data txn payload over the group G, g (see
+// group_of_payload) that a non-interactive challenge is derived from
+FiatShamirContext fiat_shamir_context(const json &payload, const string &G, const string &g)
+{
+  FiatShamirContext context;
+  context.G = G;
+  context.g = g;
+  context.g_a = payload.at("g_a").get<string>();
+  context.g_r = payload.at("g_r").get<string>();
+  context.g_r_i = payload.at("g_r_i").get<std::vector<string>>();
+  return context;
+}
+
+// Answer to verify out of the data_txn, req_txn and ans_txn of a request
+ZkpAnswer answer_of_request(const json &request)
+{
+  const json &data = request.at("data_txn").at("txn_payload");
+  const json &req = request.at("req_txn").at("txn_payload");
+  std::vector<string> g_r_i = data.at("g_r_i");
+  std::vector<string> res = request.at("ans_txn").at("txn_payload").at("res");
+
+  string G, g;
+  group_of_payload(data, G, g);
+
+  ZkpAnswer answer;
+  answer.G = integer_from_string(G);
+  answer.g = integer_from_string(g);
+  answer.g_g_ab_p_r = integer_from_string(req.at("g_g_ab_p_r"));
+
+  // The challenge of a non-interactive request is recomputed rather than
+  // taken from the txn
+  if (req.count("fiat_shamir") && req.at("fiat_shamir") == 1) {
+    answer.req = fiat_shamir_challenge(fiat_shamir_context(data, G, g),
+        req.at("g_b"), req.at("g_g_ab_p_r"));
+  }
+  else {
+    answer.req = challenge_of_payload(req, g_r_i.size());
+  }
+  for (auto &s : g_r_i) {
+    answer.g_r_i.push_back(integer_from_string(s));
+  }
+  for (auto &s : res) {
+    answer.res.push_back(integer_from_string(s));
+  }
+  return answer;
+}
 
-    //  Wait for next request from client
-    socket.recv(&request);
+// Reply for a request that could not be served.
+json error_reply(const string &message, const json &token)
+{
+  std::cout << "Error :: " << message << std::endl;
 
-    std::cout << "Request :: " << (char *)request.data() << std::endl;
-    cout << std::endl << std::endl << std::endl;
-    string data_str = string((char*)request.data());
-    string sub_str = data_str.substr(0, data_str.rfind("END{}OF"));
-    std::cout << sub_str << std::endl;
+  json j = {
+    {"error", message},
+    {"token", token}
+  };
+  return j;
+}
 
-    auto json_data = json::parse(sub_str);
-    string serial = "";
+// State shared by the workers of the calculator, and what a request does
+// with it. Every pool and cache is safe to use from several workers at
+// once.
+class Calculator
+{
+  std::vector<std::unique_ptr<GroupStore>> &group_stores;
+  GroupPool &group_pool;
+  RSAKeyPool &rsa_pool;
+  ExponentPool &exponent_pool;
+  ProfileMetrics &profile_metrics;
+  LaneScheduler &scheduler;
+
+  public:
+  Calculator(std::vector<std::unique_ptr<GroupStore>> &group_stores, GroupPool &group_pool,
+      RSAKeyPool &rsa_pool, ExponentPool &exponent_pool, ProfileMetrics &profile_metrics,
+      LaneScheduler &scheduler)
+    : group_stores(group_stores), group_pool(group_pool), rsa_pool(rsa_pool),
+      exponent_pool(exponent_pool), profile_metrics(profile_metrics), scheduler(scheduler)
+  {
+  }
+
+  // Reply to a request, null for an unknown type
+  json serve(json &json_data)
+  {
+    json serial;
 
     // Request for generating DATA TXN
     if (json_data["type"] == 0) {
-      //  Do some 'work'
-      DataTxn txn(1024, 10, json_data["identity"]);
-      cout << "Generating Key pairs..." << std::endl;
-
-      //
-      // If 'with_key' flag is enabled, then you must supply the 
-      // newly generated rsa key. 
-      if (json_data["with_key"] == 1) {
-        serial = txn.serialize_data(json_data["token"]);
+      try {
+        // K, dh_key_size and rsa_key_size requested by the client
+        TxnProfile profile = TxnProfile::from_request(json_data);
+        profile_metrics.record(profile);
+
+        // A named group is used as it is; otherwise we need a fresh one.
+        DHGroup group;
+        if (!profile.group_id.empty()) {
+          const NamedGroup *named = find_named_group(profile.group_id);
+          if (named == nullptr) {
+            throw std::invalid_argument("unknown group " + profile.group_id);
+          }
+          group = named_group(*named);
+        }
+        else {
+          //  Do some 'work'
+          group = take_group(group_stores, group_pool, profile.dh_key_size);
+        }
+
+        DataTxn txn(exponent_pool, group, profile.K, json_data["identity"], profile.group_id);
+        cout << "Generating Key pairs..." << std::endl;
+
+        //
+        // If 'with_key' flag is enabled, then you must supply the 
+        // newly generated rsa key. 
+        if (profile.with_key) {
+          cout << "Finding RSA pairs ... " << std::endl;
+          RSAPair pair = rsa_pool.take(profile.rsa_key_size);
+          serial = txn.serialize_data(json_data["token"], pair);
+        }
+        else {
+          serial = txn.serialize_data_without_rsa_key(json_data["token"]);
+        }
       }
-      else {
-        serial = txn.serialize_data_without_rsa_key(json_data["token"]);
+      catch (std::exception &e) {
+        serial = error_reply(e.what(), json_data["token"]);
       }
     }
     // Request for generating REQUEST TXN
     else if (json_data["type"] == 1) {
       std::cout << json_data["token"] << std::endl;
 
-      string G = json_data["data_txn"]["txn_payload"]["G"];
-      string g = json_data["data_txn"]["txn_payload"]["g"];
+      string G, g;
       string g_a = json_data["data_txn"]["txn_payload"]["g_a"];
       string secret = json_data["data_txn"]["txn_payload"]["secret"];
       int K = json_data["data_txn"]["txn_payload"]["K"];
@@ -429,31 +695,535 @@ int main()
       string hashed_identity = json_data["identity"];
 
       try {
-        RequestTxn txn(G, g, g_a, secret, K, hashed_identity);
+        group_of_payload(json_data["data_txn"]["txn_payload"], G, g);
+
+        // Non-interactive request: the challenge comes from the commitments
+        FiatShamirContext context;
+        bool fiat_shamir = json_data.count("fiat_shamir") && json_data["fiat_shamir"] == 1;
+        if (fiat_shamir) {
+          context = fiat_shamir_context(json_data["data_txn"]["txn_payload"], G, g);
+        }
+
+        RequestTxn txn(exponent_pool, G, g, g_a, secret, K, hashed_identity,
+            fiat_shamir ? &context : nullptr);
         serial = txn.serialize_data(json_data["token"]);
       }
-      catch (std::exception e) {
-        std::cout << "Error :: " << e.what() << std::endl;
+      catch (std::exception &e) {
+        serial = error_reply(e.what(), json_data["token"]);
       }
     }
+    // Request for generating ANSWER TXN, to the request in place or to
+    // every {g_b, req, ...} of "requests" (all to the same data txn)
     else if (json_data["type"] == 2) {
-      string G = json_data["G"];
-      string g = json_data["g"];
-      string g_b = json_data["g_b"];
+      string G, g;
       std::vector<string> r_i = json_data["r_i"];
       string r = json_data["r"];
       string a = json_data["a"];
-      string req = json_data["req"];
 
-      AnswerTxn txn(G, g, g_b, r_i, r, a, req);
-      serial = txn.serialize_data(json_data["token"]);
+      try {
+        group_of_payload(json_data, G, g);
+
+        if (json_data.count("requests")) {
+          std::vector<string> g_bs, reqs, derived;
+          for (auto &item : json_data["requests"]) {
+            string item_g_b = item["g_b"];
+            bool fiat_shamir = item.count("fiat_shamir") && item["fiat_shamir"] == 1;
+
+            g_bs.push_back(item_g_b);
+            if (fiat_shamir) {
+              reqs.push_back(fiat_shamir_challenge(fiat_shamir_context(json_data, G, g),
+                  item_g_b, item["g_g_ab_p_r"]));
+              derived.push_back(reqs.back());
+            }
+            else {
+              reqs.push_back(challenge_of_payload(item, r_i.size()));
+              derived.push_back("");
+            }
+          }
+
+          AnswerTxn txn(G, g, g_bs, r_i, r, a, reqs);
+          serial = txn.serialize_batch(json_data["token"], derived);
+        }
+        else {
+          string g_b = json_data["g_b"];
+
+          // A non-interactive answer derives the challenge itself from the
+          // commitments (g_a, g_r, g_r_i) and g_g_ab_p_r of the request, so
+          // it is made in one call without waiting for the request's block.
+          string req;
+          bool fiat_shamir = json_data.count("fiat_shamir") && json_data["fiat_shamir"] == 1;
+          if (fiat_shamir) {
+            req = fiat_shamir_challenge(fiat_shamir_context(json_data, G, g),
+                g_b, json_data["g_g_ab_p_r"]);
+          }
+          else {
+            req = challenge_of_payload(json_data, r_i.size());
+          }
+
+          AnswerTxn txn(G, g, g_b, r_i, r, a, req);
+          serial = txn.serialize_data(json_data["token"], fiat_shamir ? req : "");
+        }
+      }
+      catch (std::exception &e) {
+        serial = error_reply(e.what(), json_data["token"]);
+      }
+    }
+    // Status of the background pools
+    else if (json_data["type"] == 3) {
+      json stores = json::array();
+      for (auto &store : group_stores) {
+        stores.push_back(store->status());
+      }
+
+      json j = {
+        {"group_pool", group_pool.status()},
+        {"rsa_pool", rsa_pool.status()},
+        {"exponent_pool", exponent_pool.status()},
+        {"fixed_base_tables", FixedBaseCache::shared().status()},
+        {"montgomery_contexts", MontgomeryCache::shared().status()},
+        {"shared_secrets", SharedSecretCache::shared().status()},
+        {"simd_kernel", simd_kernel_name(simd_kernel())},
+        {"wire_formats", {"json", "msgpack", "cbor"}},
+        {"group_stores", stores},
+        {"profiles", profile_metrics.status()},
+        {"lanes", scheduler.status()},
+        {"token", json_data["token"]}
+      };
+
+      cout << j << std::endl;
+      serial = j;
+    }
+    // Request for verifying ANSWER TXNs against their DATA and REQUEST TXN,
+    // either one in place or a list of them (e.g. those of a block) in
+    // "answers"
+    else if (json_data["type"] == 4) {
+      try {
+        std::vector<ZkpAnswer> answers;
+        if (json_data.count("answers")) {
+          for (auto &item : json_data["answers"]) {
+            answers.push_back(answer_of_request(item));
+          }
+        }
+        else {
+          answers.push_back(answer_of_request(json_data));
+        }
+
+        std::vector<std::vector<size_t>> failed = verify_answers(answers);
+
+        json results = json::array();
+        for (auto &f : failed) {
+          results.push_back({{"valid", f.empty()}, {"failed", f}});
+        }
+
+        json j;
+        if (json_data.count("answers")) {
+          j = {{"results", results}};
+        }
+        else {
+          j = results[0];
+        }
+        j["token"] = json_data["token"];
+
+        cout << j << std::endl;
+        serial = j;
+      }
+      catch (std::exception &e) {
+        serial = error_reply(e.what(), json_data["token"]);
+      }
+    }
+
+    return serial;
+  }
+};
+
+// Endpoint the workers push their replies to, for the broker to send
+const char *REPLIES_ENDPOINT = "inproc://calculator-replies";
+
+// Socket the calling worker pushes replies to the broker with. ZMQ
+// sockets are not thread safe, so every worker has its own.
+zmq::socket_t &reply_socket(zmq::context_t &context)
+{
+  static thread_local std::unique_ptr<zmq::socket_t> socket;
+  if (!socket) {
+    socket.reset(new zmq::socket_t(context, ZMQ_PUSH));
+    socket->connect(REPLIES_ENDPOINT);
+  }
+  return *socket;
+}
+
+// Every frame of the next message of socket
+std::vector<zmq::message_t> recv_frames(zmq::socket_t &socket)
+{
+  std::vector<zmq::message_t> frames;
+  while (true) {
+    frames.emplace_back();
+    socket.recv(&frames.back());
+
+    int more = 0;
+    size_t more_size = sizeof(more);
+    socket.getsockopt(ZMQ_RCVMORE, &more, &more_size);
+    if (!more) {
+      return frames;
+    }
+  }
+}
+
+// The JSON of a request is the whole body frame, parsed in place. Clients
+// before the length delimited framing ended it with this sentinel (and
+// maybe a NUL); those are cut off by moving the end, not by copying.
+const char FRAME_SENTINEL[] = "END{}OF{}JSON{}DATA";
+
+void frame_body(const zmq::message_t &frame, const char *&begin, const char *&end)
+{
+  const size_t SENTINEL_LENGTH = sizeof(FRAME_SENTINEL) - 1;
+
+  begin = static_cast<const char *>(frame.data());
+  end = begin + frame.size();
+  while (end > begin && end[-1] == '\0') {
+    end--;
+  }
+  if ((size_t)(end - begin) >= SENTINEL_LENGTH &&
+      memcmp(end - SENTINEL_LENGTH, FRAME_SENTINEL, SENTINEL_LENGTH) == 0) {
+    end -= SENTINEL_LENGTH;
+  }
+}
+
+// Frame that takes the reply over instead of copying it; ZMQ frees it
+// once sent.
+zmq::message_t reply_frame(string serial)
+{
+  string *owned = new string(std::move(serial));
+  return zmq::message_t(&(*owned)[0], owned->size(),
+      [](void *, void *hint) { delete static_cast<string *>(hint); }, owned);
+}
+
+// Sends the routing envelope of a request and then the reply behind it.
+// Sending hands a frame over to ZMQ, so the envelope is sent as copies
+// and stays usable for further replies.
+void send_reply(zmq::socket_t &socket, const std::vector<zmq::message_t> &envelope, string serial)
+{
+  for (auto &frame : envelope) {
+    zmq::message_t copy;
+    copy.copy(&frame);
+    socket.send(copy, ZMQ_SNDMORE);
+  }
+  zmq::message_t reply = reply_frame(std::move(serial));
+  socket.send(reply);
+}
+
+// Reply of a job on the scheduler, pushed to the broker behind the
+// envelope of its request. A reply that cannot be encoded or sent is
+// replaced by an error for token, so that the client is not left waiting.
+void send_job_reply(zmq::context_t &context, const std::vector<zmq::message_t> &envelope,
+    WireFormat format, const json &serial, const json &token)
+{
+  try {
+    send_reply(reply_socket(context), envelope, encode_reply(format, serial));
+  }
+  catch (std::exception &e) {
+    send_reply(reply_socket(context), envelope, encode_reply(format, error_reply(e.what(), token)));
+  }
+}
+
+// Lanes of the scheduler, one per request type (see Calculator::serve),
+// in the order of the types
+enum RequestLane { DATA_LANE, REQUEST_LANE, ANSWER_LANE, STATUS_LANE, VERIFY_LANE, NUM_LANES };
+
+// Unknown types queue behind the DATA TXNs
+size_t lane_of(const json &json_data)
+{
+  if (json_data.count("type") && json_data["type"].is_number_integer()) {
+    int type = json_data["type"];
+    if (type >= 0 && type < NUM_LANES) {
+      return type;
+    }
+  }
+  return DATA_LANE;
+}
+
+// Reply of the calculator to one request, an error reply when it throws
+json serve_request(Calculator &calculator, json &json_data)
+{
+  try {
+    return calculator.serve(json_data);
+  }
+  catch (std::exception &e) {
+    return error_reply(e.what(), json_data.count("token") ? json_data["token"] : json());
+  }
+}
+
+// Request type of a batch: {"type": 5, "batch": [request, ...], "token": ...}
+const int BATCH_TYPE = 5;
+
+// Spreads the operations of a batch request over the lanes of their types.
+// Each operation is a request of its own with its own token, and fails on
+// its own: its reply is an error while the others are served as usual.
+// The replies come back in order as {"results": [...], "token": ...} once
+// all are done, or with "stream": 1 each as a message of its own (behind
+// the same envelope) as soon as it is done.
+// Runs on the broker thread, so a batch that is rejected outright is
+// answered on the front end right away.
+void submit_batch(zmq::context_t &context, zmq::socket_t &frontend, LaneScheduler &scheduler,
+    Calculator &calculator, std::shared_ptr<std::vector<zmq::message_t>> envelope,
+    json &batch_request, WireFormat format)
+{
+  struct Batch
+  {
+    json token;
+    bool stream;
+    std::vector<json> requests;
+    std::vector<json> results;
+    std::atomic<size_t> remaining;
+
+    // Replies of a stream share the envelope
+    std::mutex m;
+  };
+
+  if (!batch_request["batch"].is_array()) {
+    send_reply(frontend, *envelope,
+        encode_reply(format, error_reply("batch has to be a list of requests", batch_request["token"])));
+    return;
+  }
+
+  auto batch = std::make_shared<Batch>();
+  batch->token = batch_request["token"];
+  batch->stream = batch_request.count("stream") && batch_request["stream"] == 1;
+  for (auto &request : batch_request["batch"]) {
+    batch->requests.push_back(request);
+  }
+  batch->results.resize(batch->requests.size());
+  batch->remaining = batch->requests.size();
+
+  auto reply_all = [batch] {
+    json j = {
+      {"results", batch->results},
+      {"token", batch->token}
+    };
+    return j;
+  };
+
+  if (batch->requests.empty()) {
+    send_reply(frontend, *envelope, encode_reply(format, reply_all()));
+    return;
+  }
+
+  for (size_t i = 0; i < batch->requests.size(); i++) {
+    json &request = batch->requests[i];
+    bool nested = request.count("batch") || (request.count("type") && request["type"] == BATCH_TYPE);
+
+    scheduler.submit(lane_of(request), [&context, &calculator, envelope, batch, format, reply_all, nested, i] {
+      json &request = batch->requests[i];
+      json result = nested ?
+        error_reply("batches do not nest", request.count("token") ? request["token"] : json()) :
+        serve_request(calculator, request);
+
+      if (batch->stream) {
+        std::lock_guard<std::mutex> lock(batch->m);
+        send_job_reply(context, *envelope, format, result,
+            request.count("token") ? request["token"] : json());
+        return;
+      }
+
+      batch->results[i] = result;
+      if (--batch->remaining == 0) {
+        send_job_reply(context, *envelope, format, reply_all(), batch->token);
+      }
+    });
+  }
+}
+
+// Broker of the calculator. Requests come off the ROUTER front end behind
+// the routing envelope of their client (the identity the ROUTER added,
+// and the empty delimiter of a REQ client) and are queued on the lane of
+// their type. The worker that serves one pushes the reply back behind the
+// same envelope, and the broker hands it to the ROUTER, which sends it to
+// the right client whatever order the workers finish in.
+void run_broker(zmq::context_t &context, zmq::socket_t &frontend,
+    LaneScheduler &scheduler, Calculator &calculator)
+{
+  zmq::socket_t replies(context, ZMQ_PULL);
+  replies.bind(REPLIES_ENDPOINT);
+
+  zmq::pollitem_t items[] = {
+    {static_cast<void *>(frontend), 0, ZMQ_POLLIN, 0},
+    {static_cast<void *>(replies), 0, ZMQ_POLLIN, 0}
+  };
+
+  while (true)
+  {
+    zmq::poll(items, 2, -1);
+
+    // Replies first, so that finished work leaves before new work comes in
+    if (items[1].revents & ZMQ_POLLIN) {
+      std::vector<zmq::message_t> frames = recv_frames(replies);
+      for (size_t i = 0; i < frames.size(); i++) {
+        frontend.send(frames[i], i + 1 < frames.size() ? ZMQ_SNDMORE : 0);
+      }
+      cout << "Data is sent!" << std::endl;
+    }
+
+    if (!(items[0].revents & ZMQ_POLLIN)) {
+      continue;
     }
 
-    //  Send reply back to client
-    zmq::message_t reply(serial.length() + 1);
-    memcpy((void *)reply.data(), serial.c_str(), serial.length() + 1);
-    socket.send(reply);
-    cout << "Data is sent!" << std::endl;
+    //  Next request from a client; the body is the last frame
+    auto envelope = std::make_shared<std::vector<zmq::message_t>>(recv_frames(frontend));
+    zmq::message_t request = std::move(envelope->back());
+    envelope->pop_back();
+
+    // The reply goes back in the format of the request
+    const char *begin = static_cast<const char *>(request.data());
+    const char *end = begin + request.size();
+    WireFormat format = wire_format_of(begin, end);
+    if (format == WireFormat::JSON) {
+      frame_body(request, begin, end);
+
+      std::cout << "Request :: ";
+      std::cout.write(begin, end - begin) << std::endl;
+    }
+
+    // A request that cannot be decoded gets an error without token
+    auto json_data = std::make_shared<json>();
+    try {
+      *json_data = decode_request(format, begin, end);
+    }
+    catch (std::exception &e) {
+      send_reply(frontend, *envelope, encode_reply(format, error_reply(e.what(), nullptr)));
+      continue;
+    }
+
+    if (format != WireFormat::JSON) {
+      std::cout << "Request :: " << wire_format_name(format) << " " << *json_data << std::endl;
+    }
+
+    if (!json_data->is_object()) {
+      send_reply(frontend, *envelope, encode_reply(format, error_reply("request has to be an object", nullptr)));
+      continue;
+    }
+
+    if (json_data->count("batch") || (*json_data)["type"] == BATCH_TYPE) {
+      submit_batch(context, frontend, scheduler, calculator, envelope, *json_data, format);
+      continue;
+    }
+
+    scheduler.submit(lane_of(*json_data), [&context, &calculator, envelope, json_data, format] {
+      json serial = serve_request(calculator, *json_data);
+      send_job_reply(context, *envelope, format, serial,
+          json_data->count("token") ? (*json_data)["token"] : json());
+    });
   }
+}
+
+// Usage: main [--group-store=<file made by dh-param> ...] [--search-threads=N]
+//             [--sieve-bound=N] [--rsa-pool-depth=N] [--exp-pool-depth=N]
+//             [--workers=N] [--lane=TYPE:RESERVED:PRIORITY ...] [--g-ab-ttl=SECONDS]
+int main(int argc, char **argv)
+{
+  //  Prepare our context and socket
+  zmq::context_t context(1);
+  zmq::socket_t socket(context, ZMQ_ROUTER);
+  socket.bind("tcp://*:5555");
+
+  AutoSeededRandomPool rnd;
+
+  // Map the pregenerated groups so that we can serve DATA TXN right away
+  std::vector<std::unique_ptr<GroupStore>> group_stores;
+
+  // Threads that search a safe prime when no group is ready
+  unsigned int search_threads = std::max(1u, std::thread::hardware_concurrency());
+
+  // Small primes below this bound are sieved out of safe prime candidates
+  uint32_t sieve_bound = SafePrimeSearch::DEFAULT_SIEVE_BOUND;
+
+  // RSA key pairs kept ready per key size
+  size_t rsa_pool_depth = 4;
+
+  // Ephemeral key pairs kept ready per reused group
+  size_t exp_pool_depth = 64;
+
+  // Threads that serve requests, each one at a time, reserved ones included
+  unsigned int num_workers = std::max(1u, std::thread::hardware_concurrency());
+
+  // Lane of each request type, see LaneScheduler. Answers and requests
+  // keep a worker each, whatever the DATA TXNs (which take up to seconds)
+  // have queued; status and verification borrow idle workers.
+  std::vector<LaneConfig> lanes(NUM_LANES);
+  lanes[DATA_LANE] = {"data", 0, 1};
+  lanes[REQUEST_LANE] = {"request", 2, 1};
+  lanes[ANSWER_LANE] = {"answer", 3, 1};
+  lanes[STATUS_LANE] = {"status", 4, 0};
+  lanes[VERIFY_LANE] = {"verify", 1, 0};
+
+  for (int i = 1; i < argc; i ++) {
+    string arg = argv[i];
+    if (arg.compare(0, 17, "--search-threads=") == 0) {
+      search_threads = std::max(1, std::stoi(arg.substr(17)));
+    }
+    else if (arg.compare(0, 14, "--sieve-bound=") == 0) {
+      sieve_bound = std::max(5, std::stoi(arg.substr(14)));
+    }
+    else if (arg.compare(0, 17, "--rsa-pool-depth=") == 0) {
+      rsa_pool_depth = std::max(0, std::stoi(arg.substr(17)));
+    }
+    else if (arg.compare(0, 17, "--exp-pool-depth=") == 0) {
+      exp_pool_depth = std::max(0, std::stoi(arg.substr(17)));
+    }
+    else if (arg.compare(0, 10, "--workers=") == 0) {
+      num_workers = std::max(1, std::stoi(arg.substr(10)));
+    }
+    // --lane=TYPE:RESERVED:PRIORITY
+    else if (arg.compare(0, 7, "--lane=") == 0) {
+      unsigned int type, reserved;
+      int priority;
+      if (sscanf(arg.c_str() + 7, "%u:%u:%d", &type, &reserved, &priority) == 3 && type < NUM_LANES) {
+        lanes[type].reserved = reserved;
+        lanes[type].priority = priority;
+      }
+      else {
+        std::cout << "Error :: invalid " << arg << std::endl;
+      }
+    }
+    else if (arg.compare(0, 11, "--g-ab-ttl=") == 0) {
+      SharedSecretCache::shared().set_ttl(std::max(0, std::stoi(arg.substr(11))));
+    }
+    else if (arg.compare(0, 14, "--group-store=") == 0) {
+      try {
+        group_stores.emplace_back(new GroupStore(arg.substr(14), rnd));
+        cout << "Group store :: " << group_stores.back()->status() << std::endl;
+      }
+      catch (std::exception &e) {
+        std::cout << "Error :: " << e.what() << std::endl;
+      }
+    }
+  }
+
+  // Keep safe prime groups ready for DATA TXN in the background.
+  // Other sizes are generated inline when they are requested.
+  GroupPool group_pool({1024}, 8, 2, search_threads, sieve_bound);
+
+  // Same for the RSA keys of with_key DATA TXN
+  RSAKeyPool rsa_pool({2048}, rsa_pool_depth, 1);
+
+  // And (x, g^x) of the named groups and of the groups being requested
+  ExponentPool exponent_pool(exp_pool_depth, 16, 1);
+
+  ProfileMetrics profile_metrics;
+
+  cout << "SIMD kernel :: " << simd_kernel_name(simd_kernel()) << std::endl;
+
+  // Workers of every lane, the reserved ones and those left to share.
+  // The broker thread of the calculator is this one.
+  unsigned int reserved = 0;
+  for (auto &lane : lanes) {
+    reserved += lane.reserved;
+  }
+  LaneScheduler scheduler(lanes, num_workers > reserved ? num_workers - reserved : 0);
+
+  Calculator calculator(group_stores, group_pool, rsa_pool, exponent_pool, profile_metrics, scheduler);
+
+  cout << "Workers :: " << scheduler.size() << " " << scheduler.status() << std::endl;
+  cout << "---------- TXN Calculator is started ---------------" << std::endl;
+
+  run_broker(context, socket, scheduler, calculator);
   return 0;
 }
@@ -0,0 +1,217 @@
+#ifndef MONTGOMERY_H
+#define MONTGOMERY_H
+
+#include <algorithm>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "cryptopp/integer.h"
+#include "cryptopp/modarith.h"
+
+#include "json.hpp"
+
+// Montgomery arithmetic mod n, set up once per modulus.
+//
+// ModularExponentiation builds a MontgomeryRepresentation on every call,
+// i.e. computes n' = -n^-1 mod 2^w and converts the base with a full
+// division by n. The context keeps n' (inside its MontgomeryRepresentation)
+// along with R mod n and R^2 mod n, so that a conversion is one Montgomery
+// multiplication by R^2. The representation has a mutable workspace, so
+// every operation works on its own copy and the context itself is shared
+// by all threads.
+class MontgomeryContext
+{
+  CryptoPP::Integer n;
+  CryptoPP::MontgomeryRepresentation mont;
+
+  // R = 2^(word size * words of the representation). Crypto++ rounds
+  // the words of n up (e.g. 24 to 32 for 1536 bits), so R is taken from
+  // the representation rather than from n.
+  CryptoPP::Integer r_mod_n;
+  CryptoPP::Integer r2_mod_n;
+
+  public:
+  explicit MontgomeryContext(const CryptoPP::Integer &n)
+    : n(n), mont(n)
+  {
+    r_mod_n = mont.ConvertIn(CryptoPP::Integer::One());
+    r2_mod_n = mont.ConvertIn(r_mod_n);
+  }
+
+  const CryptoPP::Integer &modulus() const { return n; }
+
+  // Arithmetic for the calling thread
+  CryptoPP::MontgomeryRepresentation arithmetic() const { return mont; }
+
+  // x R mod n, for x in [0, n)
+  CryptoPP::Integer convert_in(CryptoPP::MontgomeryRepresentation &mr, const CryptoPP::Integer &x) const
+  {
+    return mr.Multiply(x, r2_mod_n);
+  }
+
+  // 1 in Montgomery form
+  const CryptoPP::Integer &one() const { return r_mod_n; }
+
+  // x^e mod n
+  CryptoPP::Integer exponentiate(const CryptoPP::Integer &x, const CryptoPP::Integer &e) const
+  {
+    CryptoPP::MontgomeryRepresentation mr(mont);
+    CryptoPP::Integer x_in = convert_in(mr, x < n && !x.IsNegative() ? x : x % n);
+    return mr.ConvertOut(mr.Exponentiate(x_in, e));
+  }
+
+  // prod bases[i]^exponents[i] mod n, by Straus' method: the exponents
+  // are scanned together 4 bits at a time, so that all the bases share a
+  // single chain of squarings. Pays off for many bases with short
+  // exponents, e.g. the random weights of a batch verification.
+  CryptoPP::Integer multi_exponentiate(const std::vector<CryptoPP::Integer> &bases,
+      const std::vector<CryptoPP::Integer> &exponents) const
+  {
+    const unsigned int WINDOW = 4;
+    const unsigned int DIGITS = (1 << WINDOW) - 1;
+
+    if (bases.size() != exponents.size()) {
+      throw std::invalid_argument("bases and exponents differ in number");
+    }
+
+    unsigned int bits = 0;
+    for (auto &e : exponents) {
+      if (e.IsNegative()) {
+        throw std::invalid_argument("negative exponent");
+      }
+      bits = std::max(bits, e.BitCount());
+    }
+
+    CryptoPP::MontgomeryRepresentation mr(mont);
+
+    // powers[i * DIGITS + d - 1] = bases[i]^d, in Montgomery form
+    std::vector<CryptoPP::Integer> powers(bases.size() * DIGITS);
+    for (size_t i = 0; i < bases.size(); i++) {
+      CryptoPP::Integer *row = &powers[i * DIGITS];
+      row[0] = convert_in(mr, bases[i] < n && !bases[i].IsNegative() ? bases[i] : bases[i] % n);
+      for (unsigned int d = 1; d < DIGITS; d++) {
+        row[d] = mr.Multiply(row[d - 1], row[0]);
+      }
+    }
+
+    CryptoPP::Integer acc;
+    bool started = false;
+
+    for (size_t j = (bits + WINDOW - 1) / WINDOW; j-- > 0;) {
+      if (started) {
+        for (unsigned int k = 0; k < WINDOW; k++) {
+          acc = mr.Square(acc);
+        }
+      }
+
+      for (size_t i = 0; i < bases.size(); i++) {
+        unsigned int d = (unsigned int)exponents[i].GetBits(j * WINDOW, WINDOW);
+        if (d == 0) {
+          continue;
+        }
+
+        if (started) {
+          acc = mr.Multiply(acc, powers[i * DIGITS + d - 1]);
+        }
+        else {
+          acc = powers[i * DIGITS + d - 1];
+          started = true;
+        }
+      }
+    }
+
+    return started ? mr.ConvertOut(acc) : CryptoPP::Integer::One();
+  }
+
+  // a b mod n
+  CryptoPP::Integer multiply(const CryptoPP::Integer &a, const CryptoPP::Integer &b) const
+  {
+    CryptoPP::MontgomeryRepresentation mr(mont);
+    // (a R) b R^-1 = a b
+    CryptoPP::Integer a_in = convert_in(mr, a % n);
+    return mr.Multiply(a_in, b % n);
+  }
+};
+
+// Contexts of the moduli in use, shared across requests and threads;
+// the least recently used one is dropped first.
+class MontgomeryCache
+{
+  typedef std::shared_ptr<const MontgomeryContext> Context;
+
+  size_t capacity;
+
+  std::mutex m;
+  size_t hits = 0;
+  size_t misses = 0;
+
+  // Most recently used modulus at the front
+  std::list<std::string> lru;
+  std::map<std::string, std::pair<Context, std::list<std::string>::iterator>> entries;
+
+  static std::string key_of(const CryptoPP::Integer &n)
+  {
+    std::string key(n.MinEncodedSize(), '\0');
+    n.Encode((CryptoPP::byte *)&key[0], key.size());
+    return key;
+  }
+
+  public:
+  explicit MontgomeryCache(size_t capacity) : capacity(capacity) {}
+
+  // n has to be odd
+  Context context(const CryptoPP::Integer &n)
+  {
+    std::string key = key_of(n);
+    {
+      std::lock_guard<std::mutex> lock(m);
+      auto it = entries.find(key);
+      if (it != entries.end()) {
+        hits++;
+        lru.splice(lru.begin(), lru, it->second.second);
+        return it->second.first;
+      }
+      misses++;
+    }
+
+    Context built = std::make_shared<const MontgomeryContext>(n);
+
+    std::lock_guard<std::mutex> lock(m);
+    if (entries.count(key)) {
+      return entries[key].first;
+    }
+
+    lru.push_front(key);
+    entries[key] = std::make_pair(built, lru.begin());
+
+    if (entries.size() > capacity) {
+      entries.erase(lru.back());
+      lru.pop_back();
+    }
+    return built;
+  }
+
+  nlohmann::json status()
+  {
+    std::lock_guard<std::mutex> lock(m);
+    return {
+      {"moduli", entries.size()},
+      {"hits", hits},
+      {"misses", misses}
+    };
+  }
+
+  // Cache shared by the whole calculator.
+  static MontgomeryCache &shared()
+  {
+    static MontgomeryCache cache(256);
+    return cache;
+  }
+};
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef RSA_KEY_CACHE_H
+#define RSA_KEY_CACHE_H
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "cryptopp/rsa.h"
+#include "cryptopp/pem.h"
+#include "cryptopp/sha.h"
+#include "cryptopp/filters.h"
+
+#include "thread_pool.h"
+
+// Parsed RSA public keys (ready to use OAEP encryptors) keyed by the
+// SHA-256 fingerprint of their PEM, so that encrypting for a user does
+// not parse the PEM and set up the encryptor on every call.
+//
+// The encryptors are only read after they are built; Encrypt is const
+// and every caller brings its own RNG, so they are shared by all threads.
+class RSAKeyCache
+{
+  typedef std::shared_ptr<const CryptoPP::RSAES_OAEP_SHA_Encryptor> Encryptor;
+
+  size_t capacity;
+
+  std::mutex m;
+
+  // Most recently used fingerprint at the front
+  std::list<std::string> lru;
+  std::map<std::string, std::pair<Encryptor, std::list<std::string>::iterator>> entries;
+
+  static std::string fingerprint(const std::string &pem)
+  {
+    std::string digest(CryptoPP::SHA256::DIGESTSIZE, '\0');
+    CryptoPP::SHA256().CalculateDigest((CryptoPP::byte *)&digest[0],
+        (const CryptoPP::byte *)pem.data(), pem.size());
+    return digest;
+  }
+
+  public:
+  explicit RSAKeyCache(size_t capacity) : capacity(capacity) {}
+
+  Encryptor encryptor(const std::string &pub_pem)
+  {
+    std::string key = fingerprint(pub_pem);
+    {
+      std::lock_guard<std::mutex> lock(m);
+      auto it = entries.find(key);
+      if (it != entries.end()) {
+        lru.splice(lru.begin(), lru, it->second.second);
+        return it->second.first;
+      }
+    }
+
+    // Parse outside of the lock; two threads may race to parse the same
+    // key, which is harmless.
+    CryptoPP::RSA::PublicKey pub;
+    CryptoPP::StringSource source(pub_pem, true);
+    CryptoPP::PEM_Load(source, pub);
+    Encryptor parsed = std::make_shared<const CryptoPP::RSAES_OAEP_SHA_Encryptor>(pub);
+
+    std::lock_guard<std::mutex> lock(m);
+    if (entries.count(key)) {
+      return entries[key].first;
+    }
+
+    lru.push_front(key);
+    entries[key] = std::make_pair(parsed, lru.begin());
+
+    if (entries.size() > capacity) {
+      entries.erase(lru.back());
+      lru.pop_back();
+    }
+    return parsed;
+  }
+
+  // Cache shared by the whole calculator.
+  static RSAKeyCache &shared()
+  {
+    static RSAKeyCache cache(1024);
+    return cache;
+  }
+};
+
+// OAEP encrypts msgs[i] with the public key pub_pems[i] for every i,
+// spread over the workers of pool. Each worker uses its own RNG.
+inline std::vector<std::string> oaep_encrypt_batch(const std::vector<std::string> &pub_pems,
+    const std::vector<std::string> &msgs, ThreadPool &pool = ThreadPool::shared())
+{
+  std::vector<std::string> ciphers(msgs.size());
+
+  pool.parallel_for(msgs.size(), [&](size_t i) {
+    auto encryptor = RSAKeyCache::shared().encryptor(pub_pems[i]);
+    CryptoPP::StringSource ss(msgs[i], true,
+        new CryptoPP::PK_EncryptorFilter(thread_rng(), *encryptor,
+          new CryptoPP::StringSink(ciphers[i])));
+  });
+
+  return ciphers;
+}
+
+// Same with one public key for all the messages.
+inline std::vector<std::string> oaep_encrypt_batch(const std::string &pub_pem,
+    const std::vector<std::string> &msgs, ThreadPool &pool = ThreadPool::shared())
+{
+  std::vector<std::string> ciphers(msgs.size());
+  auto encryptor = RSAKeyCache::shared().encryptor(pub_pem);
+
+  pool.parallel_for(msgs.size(), [&](size_t i) {
+    CryptoPP::StringSource ss(msgs[i], true,
+        new CryptoPP::PK_EncryptorFilter(thread_rng(), *encryptor,
+          new CryptoPP::StringSink(ciphers[i])));
+  });
+
+  return ciphers;
+}
+
+#endif
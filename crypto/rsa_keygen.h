@@ -0,0 +1,116 @@
+#ifndef RSA_KEYGEN_H
+#define RSA_KEYGEN_H
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "cryptopp/osrng.h"
+#include "cryptopp/integer.h"
+#include "cryptopp/nbtheory.h"
+#include "cryptopp/rsa.h"
+
+// RSA key generation with the two primes searched concurrently.
+//
+// With two threads p and q are found side by side. With more threads the
+// search is speculative: every thread hunts a prime of the same size and
+// the first two winners become p and q, which trims the long tail of the
+// prime search when the key pool has run dry.
+class RSAKeyGen
+{
+  // Same public exponent as CryptoPP::InvertibleRSAFunction
+  static const long PUBLIC_EXPONENT = 17;
+
+  // Candidates tried from one random start before picking a new one.
+  static const unsigned int RANGE = 4096;
+
+  unsigned int prime_size;
+
+  std::mutex m;
+  std::vector<CryptoPP::Integer> primes;
+  std::atomic<bool> done;
+
+  // p - 1 must be coprime to e, so e is invertible (e is a prime)
+  static bool is_acceptable(const CryptoPP::Integer &p)
+  {
+    return p % (CryptoPP::word)PUBLIC_EXPONENT != 1;
+  }
+
+  void search()
+  {
+    CryptoPP::AutoSeededRandomPool rnd;
+
+    // Same bounds as CryptoPP::MakeParametersForTwoPrimesOfEqualSize, so
+    // that the product of two primes always has exactly 2 * prime_size bits
+    const CryptoPP::Integer min_p = CryptoPP::Integer(182) << (prime_size - 8);
+    const CryptoPP::Integer max_p = CryptoPP::Integer::Power2(prime_size) - 1;
+
+    while (!done.load(std::memory_order_relaxed)) {
+      CryptoPP::Integer p(rnd, min_p, max_p, CryptoPP::Integer::ANY, 1, 2);
+
+      for (unsigned int i = 0; i < RANGE && p <= max_p; i++, p += 2) {
+        if (done.load(std::memory_order_relaxed)) {
+          return;
+        }
+
+        if (!CryptoPP::SmallDivisorsTest(p) || !is_acceptable(p) || !CryptoPP::IsPrime(p)) {
+          continue;
+        }
+
+        std::lock_guard<std::mutex> lock(m);
+        if (primes.size() < 2 && (primes.empty() || primes[0] != p)) {
+          primes.push_back(p);
+        }
+        if (primes.size() == 2) {
+          done = true;
+        }
+
+        // A thread that found its prime starts over from a new range
+        break;
+      }
+    }
+  }
+
+  explicit RSAKeyGen(unsigned int key_size) : prime_size(key_size / 2), done(false) {}
+
+  public:
+  // Generates a key_size bit key on num_threads threads. A single thread
+  // takes the plain CryptoPP path.
+  static CryptoPP::InvertibleRSAFunction generate(unsigned int key_size, unsigned int num_threads)
+  {
+    if (num_threads <= 1) {
+      CryptoPP::AutoSeededRandomPool rnd;
+      CryptoPP::InvertibleRSAFunction rsa;
+      rsa.GenerateRandomWithKeySize(rnd, key_size);
+      return rsa;
+    }
+
+    RSAKeyGen gen(key_size);
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < num_threads; i++) {
+      threads.emplace_back(&RSAKeyGen::search, &gen);
+    }
+    for (auto &t : threads) {
+      t.join();
+    }
+
+    // Assemble the CRT key the way InvertibleRSAFunction::GenerateRandom does
+    const CryptoPP::Integer &p = gen.primes[0];
+    const CryptoPP::Integer &q = gen.primes[1];
+    const CryptoPP::Integer e(PUBLIC_EXPONENT);
+
+    CryptoPP::Integer n = p * q;
+    CryptoPP::Integer d = e.InverseMod(CryptoPP::LCM(p - 1, q - 1));
+    CryptoPP::Integer dp = d % (p - 1);
+    CryptoPP::Integer dq = d % (q - 1);
+    CryptoPP::Integer u = q.InverseMod(p);
+
+    CryptoPP::InvertibleRSAFunction rsa;
+    rsa.Initialize(n, e, d, p, q, dp, dq, u);
+    return rsa;
+  }
+};
+
+#endif
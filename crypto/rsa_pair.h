@@ -0,0 +1,69 @@
+#ifndef RSA_PAIR_H
+#define RSA_PAIR_H
+
+#include <string>
+#include <vector>
+
+#include "cryptopp/osrng.h"
+#include "cryptopp/misc.h"
+#include "cryptopp/rsa.h"
+#include "cryptopp/pem.h"
+#include "cryptopp/files.h"
+
+#include "rsa_keygen.h"
+#include "rsa_key_cache.h"
+
+// RSA key pair of a user, PEM encoded.
+struct RSAPair
+{
+  std::string str_prv;
+  std::string str_pub;
+
+  public:
+  // With more than one thread the primes are searched concurrently,
+  // see RSAKeyGen.
+  RSAPair(int key_size, unsigned int num_threads = 1)
+  {
+    CryptoPP::InvertibleRSAFunction rsa = RSAKeyGen::generate(key_size, num_threads);
+
+    CryptoPP::RSA::PrivateKey priv(rsa);
+    CryptoPP::RSA::PublicKey pub(rsa);
+
+    CryptoPP::StringSink fs(str_prv);
+    CryptoPP::PEM_Save(fs, priv);
+
+    CryptoPP::StringSink fs2(str_pub);
+    CryptoPP::PEM_Save(fs2, pub);
+
+    // Remove trailing newline character
+    if (str_pub[str_pub.length() - 1] == '\n') {
+      str_pub.erase(str_pub.length() - 1);
+    }
+    if (str_prv[str_prv.length() - 1] == '\n') {
+      str_prv.erase(str_prv.length() - 1);
+    }
+  }
+
+  // The private key should not outlive the pair in memory.
+  ~RSAPair()
+  {
+    if (!str_prv.empty()) {
+      CryptoPP::SecureWipeArray(&str_prv[0], str_prv.size());
+    }
+  }
+
+  RSAPair(const RSAPair &) = default;
+  RSAPair(RSAPair &&) = default;
+  RSAPair &operator=(const RSAPair &) = default;
+  RSAPair &operator=(RSAPair &&) = default;
+
+  // Encrypts every message with the public key of this pair. The parsed
+  // key comes from RSAKeyCache and the messages are spread over the
+  // shared thread pool.
+  std::vector<std::string> encrypt(const std::vector<std::string> &msgs) const
+  {
+    return oaep_encrypt_batch(str_pub, msgs);
+  }
+};
+
+#endif
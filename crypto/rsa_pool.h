@@ -0,0 +1,199 @@
+#ifndef RSA_POOL_H
+#define RSA_POOL_H
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "json.hpp"
+#include "rsa_pair.h"
+
+// Keeps RSA key pairs (already PEM encoded) of every registered key size
+// ready, so that a with_key DATA TXN pops a key instead of searching two
+// primes while the client waits. Works like GroupPool.
+//
+// Pairs that are never handed out are wiped when the pool goes away
+// (see ~RSAPair).
+class RSAKeyPool
+{
+  struct Shelf
+  {
+    std::deque<RSAPair> pairs;
+    size_t in_flight = 0;
+
+    size_t generated = 0;
+    size_t hits = 0;
+    size_t misses = 0;
+    double busy_sec = 0;
+  };
+
+  std::map<unsigned int, Shelf> shelves;
+  size_t depth;
+
+  // Pairs that are being generated inline because the pool ran dry
+  unsigned int inline_in_flight = 0;
+
+  std::mutex m;
+  std::condition_variable need_refill;
+  std::vector<std::thread> workers;
+  bool stopping = false;
+
+  std::chrono::steady_clock::time_point started;
+
+  // Picks the shelf that is missing the most pairs. Returns false when
+  // every shelf is full (counting pairs that are being generated).
+  bool pick_shelf(unsigned int &key_size)
+  {
+    size_t best_fill = depth;
+    bool picked = false;
+
+    for (auto &kv : shelves) {
+      size_t fill = kv.second.pairs.size() + kv.second.in_flight;
+      if (fill < best_fill) {
+        best_fill = fill;
+        key_size = kv.first;
+        picked = true;
+      }
+    }
+    return picked;
+  }
+
+  void refill_loop()
+  {
+    while (true) {
+      unsigned int key_size = 0;
+      {
+        std::unique_lock<std::mutex> lock(m);
+        need_refill.wait(lock, [&] { return stopping || pick_shelf(key_size); });
+        if (stopping) {
+          return;
+        }
+        shelves[key_size].in_flight++;
+      }
+
+      auto begin = std::chrono::steady_clock::now();
+      RSAPair pair(key_size);
+      std::chrono::duration<double> took = std::chrono::steady_clock::now() - begin;
+
+      std::lock_guard<std::mutex> lock(m);
+      Shelf &shelf = shelves[key_size];
+      shelf.in_flight--;
+      shelf.busy_sec += took.count();
+      shelf.generated++;
+      shelf.pairs.push_back(std::move(pair));
+    }
+  }
+
+  public:
+  RSAKeyPool(const std::vector<unsigned int> &key_sizes, size_t depth, unsigned int num_threads)
+    : depth(depth), started(std::chrono::steady_clock::now())
+  {
+    for (unsigned int key_size : key_sizes) {
+      shelves[key_size];
+    }
+
+    for (unsigned int i = 0; i < num_threads; i++) {
+      workers.emplace_back(&RSAKeyPool::refill_loop, this);
+    }
+  }
+
+  ~RSAKeyPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m);
+      stopping = true;
+    }
+    need_refill.notify_all();
+
+    for (auto &worker : workers) {
+      worker.join();
+    }
+  }
+
+  RSAKeyPool(const RSAKeyPool &) = delete;
+  RSAKeyPool &operator=(const RSAKeyPool &) = delete;
+
+  // Pops a pair of the given size. Only when the shelf is empty the pair
+  // is generated inline. Like GroupPool, a size the pool was not made with
+  // has no shelf and is always generated inline.
+  //
+  // Inline generation searches the primes on all the cores, shared among
+  // the requests that are waiting for a pair at the same time.
+  RSAPair take(unsigned int key_size)
+  {
+    unsigned int num_threads;
+    {
+      std::lock_guard<std::mutex> lock(m);
+      auto it = shelves.find(key_size);
+
+      if (it != shelves.end()) {
+        Shelf &shelf = it->second;
+        if (!shelf.pairs.empty()) {
+          RSAPair pair = std::move(shelf.pairs.front());
+          shelf.pairs.pop_front();
+          shelf.hits++;
+
+          std::cout << "RSA pool (" << key_size << ") :: "
+            << shelf.pairs.size() << "/" << depth << std::endl;
+
+          need_refill.notify_one();
+          return pair;
+        }
+        shelf.misses++;
+        need_refill.notify_one();
+      }
+
+      inline_in_flight++;
+      num_threads = std::max(2u, std::thread::hardware_concurrency() / inline_in_flight);
+    }
+
+    // No longer in flight once RSAPair returns or throws
+    struct InFlight
+    {
+      RSAKeyPool &pool;
+      ~InFlight()
+      {
+        std::lock_guard<std::mutex> lock(pool.m);
+        pool.inline_in_flight--;
+      }
+    } in_flight{*this};
+
+    std::cout << "RSA pool (" << key_size << ") is empty; generating inline on "
+      << num_threads << " threads" << std::endl;
+    return RSAPair(key_size, num_threads);
+  }
+
+  nlohmann::json status()
+  {
+    std::lock_guard<std::mutex> lock(m);
+    std::chrono::duration<double> uptime = std::chrono::steady_clock::now() - started;
+
+    nlohmann::json result = nlohmann::json::array();
+    for (auto &kv : shelves) {
+      const Shelf &shelf = kv.second;
+
+      double refill_per_min = uptime.count() > 0 ? shelf.generated * 60.0 / uptime.count() : 0;
+      double sec_per_pair = shelf.generated > 0 ? shelf.busy_sec / shelf.generated : 0;
+
+      result.push_back({
+          {"key_size", kv.first},
+          {"available", shelf.pairs.size()},
+          {"depth", depth},
+          {"in_flight", shelf.in_flight},
+          {"generated", shelf.generated},
+          {"hits", shelf.hits},
+          {"misses", shelf.misses},
+          {"refill_per_min", refill_per_min},
+          {"sec_per_pair", sec_per_pair}});
+    }
+    return result;
+  }
+};
+
+#endif
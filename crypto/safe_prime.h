@@ -0,0 +1,156 @@
+#ifndef SAFE_PRIME_H
+#define SAFE_PRIME_H
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "cryptopp/osrng.h"
+#include "cryptopp/integer.h"
+#include "cryptopp/nbtheory.h"
+
+#include "safe_prime_sieve.h"
+
+// Parallel search of a safe prime p = 2q + 1 (both p and q prime).
+//
+// Every thread walks its own range of candidates starting from a random
+// q, and all of them stop as soon as one thread finds a safe prime.
+//
+// Only q = 11 (mod 12) is tried. Then p = 23 (mod 24), so neither q nor
+// p is divisible by 2 or 3, and since p = 7 (mod 8) the generator 2 is a
+// quadratic residue; it generates the subgroup of order q.
+//
+// Each range first goes through DoubleSieve, so that a candidate reaches
+// the probable prime tests only when neither q nor p has a factor below
+// the sieve bound. counts() tells how many candidates survived each stage.
+class SafePrimeSearch
+{
+  // Candidates sieved from one random start before picking a new one.
+  static const unsigned int RANGE = 1 << 14;
+
+  unsigned int bit_size;
+  const SmallPrimeTable &table;
+
+  std::atomic<bool> found;
+  CryptoPP::Integer p;
+  CryptoPP::Integer q;
+
+  std::mutex counts_m;
+  SieveCounts total;
+
+  // Tables are kept for the life of the process, one per bound.
+  static const SmallPrimeTable &table_for(uint32_t bound)
+  {
+    static std::mutex m;
+    static std::map<uint32_t, std::unique_ptr<SmallPrimeTable>> tables;
+
+    std::lock_guard<std::mutex> lock(m);
+    std::unique_ptr<SmallPrimeTable> &table = tables[bound];
+    if (!table) {
+      table.reset(new SmallPrimeTable(bound));
+    }
+    return *table;
+  }
+
+  // A small prime must not be the candidate itself; only sieve with
+  // primes below the smallest q when the group is tiny.
+  static uint32_t sieve_bound_for(unsigned int bit_size, uint32_t sieve_bound)
+  {
+    if (bit_size - 2 < 32) {
+      sieve_bound = std::min<uint64_t>(sieve_bound, (uint64_t)1 << (bit_size - 2));
+    }
+    return sieve_bound;
+  }
+
+  void search()
+  {
+    CryptoPP::AutoSeededRandomPool rnd;
+    DoubleSieve sieve(table, RANGE);
+    SieveCounts counts;
+
+    // q has bit_size - 1 bits so that p has exactly bit_size bits. The
+    // whole range fits below the largest q unless the group is tiny.
+    const CryptoPP::Integer min_q = CryptoPP::Integer::Power2(bit_size - 2);
+    const CryptoPP::Integer max_q = CryptoPP::Integer::Power2(bit_size - 1) - 1;
+    CryptoPP::Integer max_start = max_q - (long)(SmallPrimeTable::STEP * RANGE);
+    if (max_start < min_q + 12) {
+      max_start = min_q + 12;
+    }
+
+    while (!found.load(std::memory_order_relaxed)) {
+      CryptoPP::Integer start(rnd, min_q, max_start, CryptoPP::Integer::ANY, 11, 12);
+      sieve.reset(start);
+
+      CryptoPP::Integer cand_q;
+      while (sieve.next(cand_q)) {
+        if (found.load(std::memory_order_relaxed) || cand_q > max_q) {
+          break;
+        }
+        counts.after_sieve++;
+
+        // Cheapest tests first; same order as CryptoPP::PrimeAndGenerator
+        if (!CryptoPP::IsStrongProbablePrime(cand_q, 2)) {
+          continue;
+        }
+        counts.after_q_test++;
+
+        CryptoPP::Integer cand_p = (cand_q << 1) + 1;
+        if (!CryptoPP::IsStrongProbablePrime(cand_p, 2)) {
+          continue;
+        }
+        counts.after_p_test++;
+
+        if (CryptoPP::IsPrime(cand_q) && CryptoPP::IsPrime(cand_p)) {
+          counts.safe_primes++;
+
+          // Only the first winner writes; run() joins before reading
+          if (!found.exchange(true)) {
+            q = cand_q;
+            p = cand_p;
+          }
+          break;
+        }
+      }
+      counts.candidates += sieve.position();
+    }
+
+    std::lock_guard<std::mutex> lock(counts_m);
+    total += counts;
+  }
+
+  public:
+  static const uint32_t DEFAULT_SIEVE_BOUND = 1 << 16;
+
+  SafePrimeSearch(unsigned int bit_size, uint32_t sieve_bound = DEFAULT_SIEVE_BOUND)
+    : bit_size(bit_size), table(table_for(sieve_bound_for(bit_size, sieve_bound))), found(false) {}
+
+  // Runs the search on num_threads threads and blocks until the first
+  // safe prime is found.
+  void run(unsigned int num_threads)
+  {
+    if (num_threads <= 1) {
+      search();
+      return;
+    }
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < num_threads; i++) {
+      threads.emplace_back(&SafePrimeSearch::search, this);
+    }
+    for (auto &t : threads) {
+      t.join();
+    }
+  }
+
+  const CryptoPP::Integer &prime() const { return p; }
+  const CryptoPP::Integer &sub_prime() const { return q; }
+  CryptoPP::Integer generator() const { return CryptoPP::Integer::Two(); }
+
+  const SieveCounts &counts() const { return total; }
+};
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef SAFE_PRIME_SIEVE_H
+#define SAFE_PRIME_SIEVE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "cryptopp/integer.h"
+#include "json.hpp"
+
+// How many safe prime candidates survive each stage of the search.
+// Used to tune the sieve bound: a larger bound leaves fewer candidates
+// for the (expensive) probable prime tests but costs more to sieve.
+struct SieveCounts
+{
+  uint64_t candidates = 0;   // q values that were considered
+  uint64_t after_sieve = 0;  // neither q nor 2q + 1 has a small factor
+  uint64_t after_q_test = 0; // q is a strong probable prime to base 2
+  uint64_t after_p_test = 0; // 2q + 1 is a strong probable prime to base 2
+  uint64_t safe_primes = 0;  // both passed the full primality test
+
+  SieveCounts &operator+=(const SieveCounts &other)
+  {
+    candidates += other.candidates;
+    after_sieve += other.after_sieve;
+    after_q_test += other.after_q_test;
+    after_p_test += other.after_p_test;
+    safe_primes += other.safe_primes;
+    return *this;
+  }
+
+  nlohmann::json to_json() const
+  {
+    return {
+      {"candidates", candidates},
+      {"after_sieve", after_sieve},
+      {"after_q_test", after_q_test},
+      {"after_p_test", after_p_test},
+      {"safe_primes", safe_primes}
+    };
+  }
+};
+
+// Table of the small primes used by DoubleSieve. 2 and 3 are left out
+// because the candidates are already chosen to avoid them.
+class SmallPrimeTable
+{
+  std::vector<uint32_t> primes;
+
+  // 12^-1 mod s for every prime s in the table
+  std::vector<uint32_t> inv_step;
+
+  static uint32_t inverse(uint64_t a, uint64_t s)
+  {
+    // s is prime, so a^-1 = a^(s - 2) mod s
+    uint64_t result = 1, e = s - 2;
+    a %= s;
+    while (e > 0) {
+      if (e & 1) {
+        result = result * a % s;
+      }
+      a = a * a % s;
+      e >>= 1;
+    }
+    return result;
+  }
+
+  public:
+  static const uint32_t STEP = 12;
+
+  // Primes 5 <= s < bound (Sieve of Eratosthenes).
+  explicit SmallPrimeTable(uint32_t bound)
+  {
+    std::vector<bool> composite(bound, false);
+    for (uint64_t i = 2; i < bound; i++) {
+      if (composite[i]) {
+        continue;
+      }
+      if (i >= 5) {
+        primes.push_back(i);
+        inv_step.push_back(inverse(STEP, i));
+      }
+      for (uint64_t j = i * i; j < bound; j += i) {
+        composite[j] = true;
+      }
+    }
+  }
+
+  size_t size() const { return primes.size(); }
+  uint32_t prime(size_t i) const { return primes[i]; }
+  uint32_t step_inverse(size_t i) const { return inv_step[i]; }
+};
+
+// Incremental sieve over the safe prime candidates q0 + 12k, 0 <= k < length.
+//
+// For every small prime s it crosses out the k for which s divides q, and
+// the k for which s divides p = 2q + 1. Both are one arithmetic
+// progression with difference s, found from q0 mod s only, so a whole
+// range of candidates is sieved with a single bignum division per prime.
+class DoubleSieve
+{
+  const SmallPrimeTable &table;
+  std::vector<uint8_t> crossed;
+  CryptoPP::Integer base;
+  size_t next_k = 0;
+
+  public:
+  DoubleSieve(const SmallPrimeTable &table, size_t length)
+    : table(table), crossed(length) {}
+
+  // Start sieving the range beginning at q0.
+  void reset(const CryptoPP::Integer &q0)
+  {
+    base = q0;
+    next_k = 0;
+    std::fill(crossed.begin(), crossed.end(), 0);
+
+    const uint64_t length = crossed.size();
+    for (size_t i = 0; i < table.size(); i++) {
+      const uint64_t s = table.prime(i);
+      const uint64_t inv = table.step_inverse(i);
+      const uint64_t r = q0 % (CryptoPP::word)s;
+
+      // s | q0 + 12k           <=>  k = -r / 12 (mod s)
+      // s | 2(q0 + 12k) + 1   <=>  k = ((s - 1) / 2 - r) / 12 (mod s)
+      uint64_t k_q = (s - r) % s * inv % s;
+      uint64_t k_p = ((s - 1) / 2 + s - r) % s * inv % s;
+
+      for (uint64_t k = k_q; k < length; k += s) {
+        crossed[k] = 1;
+      }
+      for (uint64_t k = k_p; k < length; k += s) {
+        crossed[k] = 1;
+      }
+    }
+  }
+
+  // Returns the next candidate of the range that survived the sieve.
+  bool next(CryptoPP::Integer &q)
+  {
+    while (next_k < crossed.size() && crossed[next_k]) {
+      next_k++;
+    }
+    if (next_k == crossed.size()) {
+      return false;
+    }
+
+    q = base + CryptoPP::Integer((long)(next_k * SmallPrimeTable::STEP));
+    next_k++;
+    return true;
+  }
+
+  // Number of candidates of the range looked at so far.
+  size_t position() const { return next_k; }
+};
+
+#endif
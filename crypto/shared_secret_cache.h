@@ -0,0 +1,165 @@
+#ifndef SHARED_SECRET_CACHE_H
+#define SHARED_SECRET_CACHE_H
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "cryptopp/secblock.h"
+#include "cryptopp/sha.h"
+
+#include "json.hpp"
+
+// Shared secrets g_ab = g_b^a mod G of the answers made lately. Retries,
+// re-broadcasts and several answers to the same request all need the same
+// g_ab, which is one full exponentiation mod G.
+//
+// Entries are keyed by SHA-256 of (G, g_b, a), so a is not kept in the
+// clear, and the secrets are held in SecByteBlocks, which are zeroed when
+// an entry is evicted, expires or is cleared. An entry lives for ttl
+// seconds after it was computed (0 turns the cache off), and at most
+// capacity of them are kept, least recently used dropped first.
+class SharedSecretCache
+{
+  typedef std::chrono::steady_clock Clock;
+
+  struct Entry
+  {
+    CryptoPP::SecByteBlock g_ab;
+    Clock::time_point expires;
+    std::list<std::string>::iterator position;
+  };
+
+  size_t capacity;
+  unsigned int ttl;
+
+  std::mutex m;
+  size_t hits = 0;
+  size_t misses = 0;
+  size_t expired = 0;
+
+  // Most recently used key at the front
+  std::list<std::string> lru;
+  std::map<std::string, Entry> entries;
+
+  void erase(std::map<std::string, Entry>::iterator it)
+  {
+    lru.erase(it->second.position);
+    entries.erase(it);
+  }
+
+  public:
+  SharedSecretCache(size_t capacity, unsigned int ttl) : capacity(capacity), ttl(ttl) {}
+
+  // Key of G, g_b and a as the txns carry them
+  static std::string key_of(const std::string &G, const std::string &g_b, const std::string &a)
+  {
+    CryptoPP::SHA256 hash;
+    for (const std::string *s : {&G, &g_b, &a}) {
+      uint32_t len = s->size();
+      CryptoPP::byte prefix[4] = {
+        (CryptoPP::byte)(len >> 24), (CryptoPP::byte)(len >> 16),
+        (CryptoPP::byte)(len >> 8), (CryptoPP::byte)len};
+      hash.Update(prefix, sizeof(prefix));
+      hash.Update((const CryptoPP::byte *)s->data(), s->size());
+    }
+
+    std::string key(CryptoPP::SHA256::DIGESTSIZE, '\0');
+    hash.Final((CryptoPP::byte *)&key[0]);
+    return key;
+  }
+
+  void set_ttl(unsigned int seconds)
+  {
+    std::lock_guard<std::mutex> lock(m);
+    ttl = seconds;
+    if (ttl == 0) {
+      lru.clear();
+      entries.clear();
+    }
+  }
+
+  // Copies the big endian bytes of g_ab into out; false when the key is
+  // unknown or its entry expired.
+  bool find(const std::string &key, CryptoPP::SecByteBlock &out)
+  {
+    std::lock_guard<std::mutex> lock(m);
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+      misses++;
+      return false;
+    }
+    if (it->second.expires <= Clock::now()) {
+      expired++;
+      misses++;
+      erase(it);
+      return false;
+    }
+
+    hits++;
+    lru.splice(lru.begin(), lru, it->second.position);
+    out = it->second.g_ab;
+    return true;
+  }
+
+  void insert(const std::string &key, const CryptoPP::byte *g_ab, size_t size)
+  {
+    std::lock_guard<std::mutex> lock(m);
+    if (ttl == 0 || capacity == 0) {
+      return;
+    }
+
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+      erase(it);
+    }
+
+    lru.push_front(key);
+    Entry &entry = entries[key];
+    entry.g_ab.Assign(g_ab, size);
+    entry.expires = Clock::now() + std::chrono::seconds(ttl);
+    entry.position = lru.begin();
+
+    // Beyond capacity, and whatever expired at the tail
+    const Clock::time_point now = Clock::now();
+    while (entries.size() > capacity || entries[lru.back()].expires <= now) {
+      auto last = entries.find(lru.back());
+      if (last->second.expires <= now) {
+        expired++;
+      }
+      erase(last);
+    }
+  }
+
+  void clear()
+  {
+    std::lock_guard<std::mutex> lock(m);
+    lru.clear();
+    entries.clear();
+  }
+
+  nlohmann::json status()
+  {
+    std::lock_guard<std::mutex> lock(m);
+    return {
+      {"entries", entries.size()},
+      {"ttl", ttl},
+      {"hits", hits},
+      {"misses", misses},
+      {"expired", expired}
+    };
+  }
+
+  // Cache shared by the whole calculator, 5 minutes unless configured
+  // otherwise (--g-ab-ttl).
+  static SharedSecretCache &shared()
+  {
+    static SharedSecretCache cache(4096, 300);
+    return cache;
+  }
+};
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef SIMD_MODEXP_H
+#define SIMD_MODEXP_H
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include "cryptopp/integer.h"
+
+#include "montgomery.h"
+#include "simd_mont.h"
+
+// bases[i]^exponents[i] mod n for every i, up to 8 of them at a time in
+// the SIMD lanes of simd_mont.h. Meant for batches of independent
+// exponentiations under one modulus, e.g. the K tryouts of a DATA TXN.
+//
+// Each lane runs a 4-bit fixed window exponentiation; lanes whose
+// exponents are shorter just multiply by one for the leading windows.
+// Without a SIMD kernel (or for a modulus too large or even) every item
+// takes the scalar path of MontgomeryContext.
+inline std::vector<CryptoPP::Integer> simd_exponentiate(const CryptoPP::Integer &n,
+    const std::vector<CryptoPP::Integer> &bases, const std::vector<CryptoPP::Integer> &exponents,
+    SimdKernel kernel = simd_kernel())
+{
+  const unsigned int WINDOW = 4;
+  const unsigned int ENTRIES = 1 << WINDOW;
+
+  if (bases.size() != exponents.size()) {
+    throw std::invalid_argument("bases and exponents differ in number");
+  }
+
+  std::vector<CryptoPP::Integer> results(bases.size());
+
+  SimdMont mont = simd_mont(kernel);
+  const size_t limbs = mont.kernel == SimdKernel::SCALAR ? 0 : mont.limbs_for(n.BitCount());
+  bool negative = false;
+  for (auto &e : exponents) {
+    negative = negative || e.IsNegative();
+  }
+
+  if (limbs == 0 || n.IsEven() || negative) {
+    auto context = MontgomeryCache::shared().context(n);
+    for (size_t i = 0; i < bases.size(); i++) {
+      results[i] = context->exponentiate(bases[i], exponents[i]);
+    }
+    return results;
+  }
+
+  const unsigned int lanes = mont.lanes;
+  const unsigned int limb_bits = mont.limb_bits;
+  const size_t size = limbs * lanes;
+
+  // Limb i of x into lane l of v
+  auto put = [&](std::vector<uint64_t> &v, unsigned int l, const CryptoPP::Integer &x) {
+    for (size_t i = 0; i < limbs; i++) {
+      v[i * lanes + l] = x.GetBits(i * limb_bits, limb_bits);
+    }
+  };
+  auto get = [&](const std::vector<uint64_t> &v, unsigned int l) {
+    CryptoPP::Integer x;
+    for (size_t i = limbs; i-- > 0;) {
+      x <<= limb_bits;
+      x += CryptoPP::Integer((signed long)v[i * lanes + l]);
+    }
+    return x;
+  };
+
+  const CryptoPP::Integer limb_base = CryptoPP::Integer::Power2(limb_bits);
+  const CryptoPP::Integer r = CryptoPP::Integer::Power2(limb_bits * limbs) % n;
+  const uint64_t n0 = (limb_base - n.InverseMod(limb_base)).ConvertToLong();
+
+  std::vector<uint64_t> v_n(size), v_r2(size), v_one(size), v_plain_one(size);
+  for (unsigned int l = 0; l < lanes; l++) {
+    put(v_n, l, n);
+    put(v_r2, l, r * r % n);
+    put(v_one, l, r);
+    put(v_plain_one, l, CryptoPP::Integer::One());
+  }
+
+  // table[d * size ...] = base^d of every lane, in Montgomery form
+  std::vector<uint64_t> table(ENTRIES * size), acc(size), pick(size);
+
+  for (size_t first = 0; first < bases.size(); first += lanes) {
+    const size_t count = std::min<size_t>(lanes, bases.size() - first);
+
+    // Idle lanes raise 1 to the power 0
+    std::vector<uint64_t> v_base(size);
+    unsigned int bits = 0;
+    for (unsigned int l = 0; l < lanes; l++) {
+      const CryptoPP::Integer &b = l < count ? bases[first + l] : CryptoPP::Integer::One();
+      put(v_base, l, b < n && !b.IsNegative() ? b : b % n);
+      if (l < count) {
+        bits = std::max(bits, exponents[first + l].BitCount());
+      }
+    }
+
+    std::copy(v_one.begin(), v_one.end(), table.begin());
+    mont.mul(&table[size], v_base.data(), v_r2.data(), v_n.data(), n0, limbs);
+    for (unsigned int d = 2; d < ENTRIES; d++) {
+      mont.mul(&table[d * size], &table[(d - 1) * size], &table[size], v_n.data(), n0, limbs);
+    }
+
+    std::copy(v_one.begin(), v_one.end(), acc.begin());
+    for (size_t j = (bits + WINDOW - 1) / WINDOW; j-- > 0;) {
+      for (unsigned int k = 0; k < WINDOW; k++) {
+        mont.mul(acc.data(), acc.data(), acc.data(), v_n.data(), n0, limbs);
+      }
+
+      for (unsigned int l = 0; l < lanes; l++) {
+        unsigned int d = l < count ? (unsigned int)exponents[first + l].GetBits(j * WINDOW, WINDOW) : 0;
+        for (size_t i = 0; i < limbs; i++) {
+          pick[i * lanes + l] = table[d * size + i * lanes + l];
+        }
+      }
+      mont.mul(acc.data(), acc.data(), pick.data(), v_n.data(), n0, limbs);
+    }
+
+    // Out of Montgomery form; the result is at most n
+    mont.mul(acc.data(), acc.data(), v_plain_one.data(), v_n.data(), n0, limbs);
+    for (unsigned int l = 0; l < count; l++) {
+      CryptoPP::Integer x = get(acc, l);
+      results[first + l] = x >= n ? x - n : x;
+    }
+  }
+
+  return results;
+}
+
+#endif
@@ -0,0 +1,179 @@
+#ifndef SIMD_MONT_H
+#define SIMD_MONT_H
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define SIMD_MONT_X86 1
+#endif
+
+// Montgomery multiplication of several independent operands side by side,
+// one per SIMD lane, all under the same modulus n:
+//
+//   AVX512_IFMA  8 lanes of 52-bit limbs (vpmadd52luq / vpmadd52huq)
+//   AVX2         4 lanes of 26-bit limbs (vpmuludq, 32 x 32 -> 64 bits)
+//
+// Operands are stored limb major, limb i of lane l at [i * lanes + l], and
+// so is n (the same in every lane). With R = 2^(limb_bits * limbs) > 4n,
+// inputs below 2n give a b R^-1 mod n plus at most n, i.e. again below 2n
+// (almost Montgomery multiplication), so results chain without a final
+// subtraction. Column sums are kept in 64-bit accumulators and only
+// carried once per column, which leaves room for 4096-bit moduli.
+//
+// The kernels are compiled for their instruction set with a target
+// attribute, so the rest of the calculator needs no -m flags; which one
+// runs is picked from CPUID at run time, see simd_kernel().
+
+enum class SimdKernel { SCALAR, AVX2, AVX512_IFMA };
+
+typedef void (*SimdMontMul)(uint64_t *r, const uint64_t *a, const uint64_t *b,
+    const uint64_t *n, uint64_t n0, size_t limbs);
+
+struct SimdMont
+{
+  SimdKernel kernel;
+  unsigned int lanes;
+  unsigned int limb_bits;
+  size_t max_limbs;
+  SimdMontMul mul;
+
+  // Number of limbs for a modulus of the given size, 0 when too large
+  size_t limbs_for(unsigned int modulus_bits) const
+  {
+    size_t limbs = (modulus_bits + 2 + limb_bits - 1) / limb_bits;
+    return limbs <= max_limbs ? limbs : 0;
+  }
+};
+
+#ifdef SIMD_MONT_X86
+
+namespace simd_mont_detail
+{
+  const size_t IFMA_MAX_LIMBS = 80;
+  const size_t AVX2_MAX_LIMBS = 160;
+
+  __attribute__((target("avx512f,avx512ifma")))
+  inline void mul_ifma(uint64_t *r, const uint64_t *a, const uint64_t *b,
+      const uint64_t *n, uint64_t n0, size_t limbs)
+  {
+    const __m512i mask = _mm512_set1_epi64((1ULL << 52) - 1);
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i v_n0 = _mm512_set1_epi64(n0);
+
+    // t[k] collects column k of a b + m n
+    __m512i t[2 * IFMA_MAX_LIMBS];
+    for (size_t k = 0; k < 2 * limbs; k++) {
+      t[k] = zero;
+    }
+
+    for (size_t i = 0; i < limbs; i++) {
+      const __m512i a_i = _mm512_loadu_si512(a + 8 * i);
+      for (size_t j = 0; j < limbs; j++) {
+        const __m512i b_j = _mm512_loadu_si512(b + 8 * j);
+        t[i + j] = _mm512_madd52lo_epu64(t[i + j], a_i, b_j);
+        t[i + j + 1] = _mm512_madd52hi_epu64(t[i + j + 1], a_i, b_j);
+      }
+
+      // m = t[i] (-n^-1) mod 2^52 clears the low limb of the column
+      const __m512i m = _mm512_madd52lo_epu64(zero, t[i], v_n0);
+      for (size_t j = 0; j < limbs; j++) {
+        const __m512i n_j = _mm512_loadu_si512(n + 8 * j);
+        t[i + j] = _mm512_madd52lo_epu64(t[i + j], m, n_j);
+        t[i + j + 1] = _mm512_madd52hi_epu64(t[i + j + 1], m, n_j);
+      }
+
+      t[i + 1] = _mm512_add_epi64(t[i + 1], _mm512_srli_epi64(t[i], 52));
+    }
+
+    __m512i carry = zero;
+    for (size_t j = 0; j < limbs; j++) {
+      __m512i x = _mm512_add_epi64(t[limbs + j], carry);
+      _mm512_storeu_si512(r + 8 * j, _mm512_and_si512(x, mask));
+      carry = _mm512_srli_epi64(x, 52);
+    }
+  }
+
+  __attribute__((target("avx2")))
+  inline void mul_avx2(uint64_t *r, const uint64_t *a, const uint64_t *b,
+      const uint64_t *n, uint64_t n0, size_t limbs)
+  {
+    const __m256i mask = _mm256_set1_epi64x((1LL << 26) - 1);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i v_n0 = _mm256_set1_epi64x(n0);
+
+    __m256i t[2 * AVX2_MAX_LIMBS];
+    for (size_t k = 0; k < 2 * limbs; k++) {
+      t[k] = zero;
+    }
+
+    for (size_t i = 0; i < limbs; i++) {
+      const __m256i a_i = _mm256_loadu_si256((const __m256i *)(a + 4 * i));
+      for (size_t j = 0; j < limbs; j++) {
+        const __m256i b_j = _mm256_loadu_si256((const __m256i *)(b + 4 * j));
+        t[i + j] = _mm256_add_epi64(t[i + j], _mm256_mul_epu32(a_i, b_j));
+      }
+
+      const __m256i m = _mm256_and_si256(_mm256_mul_epu32(_mm256_and_si256(t[i], mask), v_n0), mask);
+      for (size_t j = 0; j < limbs; j++) {
+        const __m256i n_j = _mm256_loadu_si256((const __m256i *)(n + 4 * j));
+        t[i + j] = _mm256_add_epi64(t[i + j], _mm256_mul_epu32(m, n_j));
+      }
+
+      t[i + 1] = _mm256_add_epi64(t[i + 1], _mm256_srli_epi64(t[i], 26));
+    }
+
+    __m256i carry = zero;
+    for (size_t j = 0; j < limbs; j++) {
+      __m256i x = _mm256_add_epi64(t[limbs + j], carry);
+      _mm256_storeu_si256((__m256i *)(r + 4 * j), _mm256_and_si256(x, mask));
+      carry = _mm256_srli_epi64(x, 26);
+    }
+  }
+}
+
+#endif
+
+// Kernel of the given kind; SCALAR has no lanes (mul is null).
+inline SimdMont simd_mont(SimdKernel kernel)
+{
+#ifdef SIMD_MONT_X86
+  if (kernel == SimdKernel::AVX512_IFMA) {
+    return {kernel, 8, 52, simd_mont_detail::IFMA_MAX_LIMBS, &simd_mont_detail::mul_ifma};
+  }
+  if (kernel == SimdKernel::AVX2) {
+    return {kernel, 4, 26, simd_mont_detail::AVX2_MAX_LIMBS, &simd_mont_detail::mul_avx2};
+  }
+#endif
+  return {SimdKernel::SCALAR, 1, 0, 0, nullptr};
+}
+
+// Best kernel this CPU runs, detected once.
+inline SimdKernel simd_kernel()
+{
+  static const SimdKernel detected = [] {
+#ifdef SIMD_MONT_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512ifma")) {
+      return SimdKernel::AVX512_IFMA;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+      return SimdKernel::AVX2;
+    }
+#endif
+    return SimdKernel::SCALAR;
+  }();
+  return detected;
+}
+
+inline const char *simd_kernel_name(SimdKernel kernel)
+{
+  switch (kernel) {
+    case SimdKernel::AVX512_IFMA: return "avx512ifma";
+    case SimdKernel::AVX2: return "avx2";
+    default: return "scalar";
+  }
+}
+
+#endif
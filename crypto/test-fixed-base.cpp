@@ -0,0 +1,189 @@
+// g++ -g -O2 -I. -I/usr/include/cryptopp test-fixed-base.cpp -o test-fixed-base.exe -lcryptopp -lpthread
+
+// Known answers of FixedBaseTable, computed independently with Python's
+// pow, over named groups of 1024 to 3072 bits and an odd 1088-bit modulus
+// with g = 5. With x1 = G / 3, x2 = 2G - G / 5 (one bit longer than G,
+// the longest exponent the table covers) and x3 = G^2 / 7 (longer, which
+// takes the generic path):
+//
+//   g^x1, g^x2 and g^x3 mod G, and g^0 = 1, g^1 = g
+//
+// Tables are built both directly and through FixedBaseCache. Exits with 1
+// on the first wrong answer.
+//
+// Usage: test-fixed-base.exe
+
+#include <iostream>
+using std::cout;
+using std::cerr;
+using std::endl;
+
+#include <string>
+using std::string;
+
+#include "cryptopp/integer.h"
+using CryptoPP::Integer;
+
+#include "named_groups.h"
+#include "fixed_base.h"
+
+struct KnownAnswer
+{
+	const char* id;
+	// nullptr for the named group of the id
+	const char* G_hex;
+	long g;
+	const char* x1_hex;
+	const char* x2_hex;
+	const char* x3_hex;
+};
+
+static const KnownAnswer ANSWERS[] = {
+	{"modp1024", nullptr, 2,
+		"EA891334AB9E731E698E6934C583B891E06F60B0B4CEAECEAD94CBC28964632D"
+		"48196486EDC28BEDB183532FBBBDC35B6F73D58A10416871A7A701D0DAA3211C"
+		"E7C8103E869EFA6BFA76D5B2201F7075254E54A2B13D59F0EEC5D21D82DCF2D4"
+		"E96A70A3EEF8B49CDB1B4549CF0016EED4F07EA482713169D536D88B77898FD9",
+		"FA21767D74554B34E60E20E9D1DB7E4CB1785212FD58106D3671866A33C04CA3"
+		"797765FE04DC31CB9AFEA1156259B4E7000BE0D854F3C7D73A015B026CB9E307"
+		"C133052E762621A2D7B281D032F4741893AA0435D0341C55590D2FB5873B53C3"
+		"541D7B44C6015D13564A57D9AC73AE86F4D2A6EB5EC9ACE5C3EF79CE99BA5FC",
+		"1"},
+	{"modp1536", nullptr, 2,
+		"885BD0D7BA8F83AE2F94772A5EDD4D8DD147F9E9526C0494073CEC2C4B7732F7"
+		"C92BFE4830D45551B8A2847053BB7FBE97561A022D12367D556AD7567969A8A1"
+		"D6329CE4C5E0FC905EC11B3F43681B7EE20F2AEEF55BDC5A0B3F9C88AB71F714"
+		"FCE091D2E783C8E7AFD27818D6D303775071803316CE8E9152076C9AD5BAEF1F"
+		"951551D05476E9CC2F3C17E232E286CCE803722D699A0886EACFEEF5850617B1"
+		"1CFD090A8875765A75335BA6DD8A3FA59498A89634EDA60A667594D64DF8F7CC",
+		"882F98EFA070C5B00B1A6C32B824C21ECF19AE8823934AB959AAE78662825E3A"
+		"DAA1F6AE076CCDC92146140B02A2C592D2FF49E8273DE916471E7E7AB60DD08C"
+		"A34950DF6DD226BF8A1E2E667F32815C47C9BE178BA02C56AEDC8F10FD5CBFF3"
+		"17DABAFCC09AD9068C5B34D297B311598577CAD78524B61C067BF70FEBCBC1D1"
+		"F653B0619476FDE09C5587D92854BA4EAED67FBAA30310726A8ED361655AA57C"
+		"673B6D296128D5B19BEAF0CCEEF55BB59605B16E65133B680B2E4595EAFDD3B5",
+		"1"},
+	{"ffdhe2048", nullptr, 2,
+		"71AE61B329627FC571DEFF59DC52F4294F3A7C8901BFF990CE219354C654AB8D"
+		"BE2F794A028E39D89008DD653F83A0F0139E39ECC5283312F2645EF6E27880BA"
+		"8409FF86CABADD8F69310360092892062B4FEDE5AB1613A772CCAFB266DD48E8"
+		"4C7091BF7C985E23CF7B648E47B69C0E881C6D3169F8EA0B42413EB469EDC708"
+		"A16281B4E9D1DBD134A5527312A09B9D4BA1F44DF9DCF11161533AEC6DACC51F"
+		"EBD33F395DAD8C55E4D92C510C550B5A9BB7E18368AD3720BAAECFD4492B25C7"
+		"196257C523C20EBC0F31D740A81DC02686946723C5D72DF56E48749B4356E33E"
+		"C4F03FC303370D9B3D1F43E3DCC9DF07753CDF14F644615D87DF4E56CA9AB21C",
+		"F5C244A9662C8BED4BA40A6366A2732C9A98102EDFD4FCE27685EEF2235B3965"
+		"B8E428F0C72E0B45403F25A7B43941F8C5424365221D2009C1C865B3F97C028B"
+		"08411E5DAD50BD57030D3384BAE723CE3BEBE0F4E8F4BCDC39258069B70B4A1C"
+		"884CCA608BD07E2CDF805B7C1CA8043944C5CE50C06095FB35E0AA624BE3A95E"
+		"6312241D675E50AE6792E3EB598D12CC61B01CA68482E79BDEA9891D5D04115A"
+		"069C5937735F0495DE78F614A90D1E4F6D717CB9E3546C64505A855159728332"
+		"AA6D8AC6BDAE31CE95D0BC952F652B3EABD8A1EB5A2CE757426002BADB99FCC0"
+		"93E58C3ADED04C1319966560890AB4FF470FA2CDAEC1E9727AFA5DF4DF6B59B8",
+		"233B476750EB4A850A9B343F427FCCCABA71415C890CCD3482E9F6465BA847EE"
+		"A7C9D8FED4D808B32AB0F2246A0D92BEF6EAFCC5DA537C01D37C4E5E2155B287"
+		"699A440193F374F01DE290A144CCC8B19A6AEABEA40F22C1A234A842E97F6DC4"
+		"E3FB4EF09036FE6D45FE04190B7DC3C7DF383E214C2B2BB391E4FDBA75C6513D"
+		"49CD97FA59E696B32E974EFCD0619719255322848953103D453BC575FE21D5BF"
+		"69AF9E4D1B7D0895B60BACB41BF2F2A3F029CA9508B814CE12B0E55F8C3D99C4"
+		"F888326B0C1ED8A1E018A5B25F21AEAB309ADB17340D7E05BAA7E33B8F044965"
+		"A68A3576E65C8E7F5A3B9B8CD89664D5B7C69217EED4C7EB7FBE9669A32919CC"},
+	{"modp3072", nullptr, 2,
+		"536E0C2BC8F7B9DE03B27816B2EDE23A522A4FBA3AFD8C312F958A3FA2E89E89"
+		"CA66AB6646E515E42447A2F4CD0E04C85A7D793B07573D5F15206894DDAB5CF8"
+		"CA110E99C1D5FA0FE2AFADF35CC9AEB88F3F9B58F186E0E924FE3BC5306A8E40"
+		"7F309A3225ADFC632D52D821C27A523F6C3E67B585C3AA0551809CE16DF758DF"
+		"ECDAA81D33B9668BC08B7CDCF1CFDB15C6418D20E84593BC8DD98CD9302F4113"
+		"79175E19F4E31D2500240781AD8F2CC61B697F3D8457250B69F31C872E0E0071"
+		"A1F6B4428EFEC27590FCE71905BE6025746F36A84E0B49E419457F737A0742A9"
+		"83162900656F3EA83D421F4DD85B9B1F1E794DAF64E1821F9A2ECD1BB103F4FA"
+		"8491E43E57A78D392CDD1E18128854855865B37BEC281ADE33D85CBA94AE6FD0"
+		"EB40826F25193F919F9128AC68FDD5521C6AEE24D226C0C20E15EE115D9DCE60"
+		"F0281381AE04572790EED454AD64137CD13D272FFD8337A706EEDB494D6C0C69"
+		"69E0338CA9C07938B53D315225DA1B86D03F089801470E3ADD58D974E68DA3D8",
+		"2D1751BA5D823F05760FF5E653B230BDE4F32F63D4BA87AAAF5C6909B403D42A"
+		"96509284C104EC07BE8AB26121553FEC63899CC9FEC8DF41CF582EC268B05024"
+		"7E937C7E246CE9286DA20E77FB635A0C0720938ED0009D4DEE015E5FBAF3985C"
+		"8E125831137A7FA2DC2AE295BD3777E8587C1BA4EDFACB8CC4882FFD83A9FBFA"
+		"CB88F8D05019A1AA495EB56E42489AEAB2C37F906C4F19B2B377F3638CBC794E"
+		"5F33E55E582AA27A76CDD28594EEF2C55FEF4001C15AD08D7D4A06BAA25B477E"
+		"8DF92983665E465F52D55590BCDC7E0BCAE48A66107AD5F05D20775B814840CB"
+		"A078A2878C68E97602809BF637BDB1C39A2923B256BC864DBDC04CC589FD97FD"
+		"77E436E5713877DA16EFDA2D2F9F9227CFC704FB7E073448F012653A1B835CA7"
+		"49D0A698AD7C4498B8ADFF3BED885382C5588EF4241AB76B1B529D28153878FE"
+		"0CFF9FCCEBB0B7C89B2653A5AFCDE76B466D1FEC8CC04785BD30589D0B59945E"
+		"A18CD85171C39F064C04DFD1DAB4DFD5E69217C2302E0D5F3C95AFCE6DCA3351",
+		"28B4CF8E3AEFC8B47D448A84ACBE37D5ECA7FBFB4CE0D3967EA2674E38D6D87E"
+		"15E433142FC2380FE4AE62370D541021973B188790EEC655349593C079773B69"
+		"3D173FA872AF5DC41B707BBEAA96A724309D818F5F4E378CADCE27D826745E2C"
+		"6928A6C72CF7C057865133E3F194152390B87AFB61ACC5A8D00D4070D49F0347"
+		"0B3C83FF57AF189002859DEB25FD8E06966A55F614C1FAA5408D46EF2FA3FA50"
+		"B67D8AB43EC5AEA417D6E3DC8CA73CC58B460662B4A84A7BD0459C10E4B9E2F9"
+		"C56FC6E672E7433C13F6F65B9F36A5E68F5E2389748F9F045F10F91B4702031B"
+		"58364690F80D324934B75626EA4BCAF040924ACE00915625F09055AF3E641F8D"
+		"D3F5AAF4C870CCBA621AC5807CB75FD823C8F6141B80F8F3FB99B82A400FA4EE"
+		"19A4D50046F02A1B41471A574C040712E53A90C0EDEC59BDF1A00042BE121C06"
+		"B5CAF45D68D596EAACC0CCA93B422B64071227B0D6C74F37F335DDEF52AA44D8"
+		"8838982882763BBC3968BBEBEAF7B341B8747316550CF4F26DEBA7804FB5D871"},
+	{"odd1088", 
+		"F0010C962F10291E61D8BA065DEBB60932D2587E7C74E5BF5DE955014025DBC0"
+		"0598FE2510329A9AC8C0868E24C86CDBA3C2A12D30A70FD15D1F317816A2E7DB"
+		"EED3417942A77DEA8BFF1EB559302CAC59EBD4F4CDF0A50FAAA0A2DB40B0825A"
+		"50B6E64223E15490CF9E9964FA88CFE96A9E483E56218C987C6E279080C5C716"
+		"A8265A49889B0931", 5,
+		"2FAD28E09ADEA5E8D4802ABF2805AD67E9E308A1331A33053AB30E24B0ABBE15"
+		"3D621C2DA554478AEB04EA925248B88F20E46B9E1CD20478BC296A17A960377B"
+		"ACB2ED16EE4FF3FF8A0D3E5F5EA196170F4FD926037348E5BC2DE70C4322E6B8"
+		"2706496D3D8469EF65E704AEDAEB9ABE5BAAEA3370E1D8871B9FDC43AC5B6285"
+		"46294BE29AFEED4D",
+		"22B6521836CC87B6BC104F31E14DFA6DEBEED0F01810DACC2C003683DFD82FFB"
+		"3B4F9509ABED16C133E9C776E493A22FD914E7934BF66F84C0ED9493722E8CC1"
+		"C8C64600F6D3431807CDD5007F170D81AFBD8457329303FDFD210ECA939458ED"
+		"0AB70FDB9B398BCD1CF309F6D6A4C05A690B1D5205E4A2630FD21FF571DCF785"
+		"0FA54450CEBCC1DB",
+		"C83C9D764735040ADEF52854D80838E7E0F9D678A7CC5C7FB9AAA6DF6A2DA948"
+		"E979F5597130065144FAE8ABFB4651578D52AD3676418AACC234E64BBEAC0B3E"
+		"DF4DE1AE3FC1031E2F1D5CD2C7AB64D46354D0CD77A62BB67EB1130C86B29E7B"
+		"1B47DC67D8AD0469B2E617757B273DA926DD0EE143C960E27DCABD45302915ED"
+		"8B95D924018D374"}
+};
+
+static Integer from_hex(const char* hex)
+{
+	return Integer((string(hex) + "h").c_str());
+}
+
+static bool check(const FixedBaseTable& table, const Integer& G, const Integer& g, const KnownAnswer& answer)
+{
+	return table.exponentiate(G / 3) == from_hex(answer.x1_hex)
+		&& table.exponentiate(2 * G - G / 5) == from_hex(answer.x2_hex)
+		&& table.exponentiate(G * G / 7) == from_hex(answer.x3_hex)
+		&& table.exponentiate(Integer::Zero()) == Integer::One()
+		&& table.exponentiate(Integer::One()) == g;
+}
+
+int main()
+{
+	int failed = 0;
+	for(const KnownAnswer& answer : ANSWERS)
+	{
+		const Integer G = answer.G_hex != nullptr ? from_hex(answer.G_hex) : named_group(*find_named_group(answer.id)).p;
+		const Integer g(answer.g);
+
+		FixedBaseTable table(G, g);
+		bool ok = check(table, G, g, answer)
+			&& FixedBaseCache::shared().find(G, g) == nullptr
+			&& check(*FixedBaseCache::shared().table(G, g), G, g, answer)
+			&& FixedBaseCache::shared().find(G, g) != nullptr;
+
+		cout << answer.id << "\t" << (ok ? "ok" : "FAILED") << endl;
+		failed += !ok;
+	}
+
+	if(failed)
+	{
+		cerr << failed << " FixedBaseTable known answers wrong" << endl;
+		return 1;
+	}
+	return 0;
+}
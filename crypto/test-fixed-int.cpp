@@ -0,0 +1,364 @@
+// g++ -g -O2 -I. -I/usr/include/cryptopp test-fixed-int.cpp -o test-fixed-int.exe -lcryptopp -lpthread
+
+// Known answers of FixedMont (fixed_int.h), computed independently with
+// Python's pow, for each width the ANSWER TXNs dispatch on: over named
+// groups (the compile time moduli) and an odd modulus of each width (the
+// FixedMontCache path). With x = n / 3:
+//
+//   x^(n / 5), x^(n^2 / 7) (a 2 Bits exponent) and x^1Fh (leading zero
+//   windows) mod n, and x^0 = 1
+//
+// Also the hex and byte conversions of FixedInt. Exits with 1 on the
+// first wrong answer.
+//
+// Usage: test-fixed-int.exe
+
+#include <iostream>
+using std::cout;
+using std::cerr;
+using std::endl;
+
+#include <memory>
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include "cryptopp/integer.h"
+using CryptoPP::Integer;
+
+#include "named_groups.h"
+#include "fixed_int.h"
+
+struct KnownAnswer
+{
+	const char* id;
+	size_t bits;
+	// nullptr for the named group of the id
+	const char* n_hex;
+	const char* exp_hex;
+	const char* wide_hex;
+	const char* short_hex;
+};
+
+static const KnownAnswer ANSWERS[] = {
+	{"modp1024", 1024, nullptr,
+		"2FC52181DA6566A992B132190572C26B8BB0B7198703F5EFDEAA1C6932EDED08"
+		"75255B6B1BE47FED96C129E26DBE1B19AC8197D951A3ED0625D2E5FF582F4595"
+		"1E00358D945C69B19016964A993A8C8C25C0E8FA2D1180D71A12064102C8967C"
+		"0F83E12D90EAF8E548246D5A6EB86EE1F1E19B4538C583BB948E5044C808E1A8",
+		"1",
+		"EC6AC77F3AA492379E075920597947B63C5EE16BC914363EA9040A154C0F3F4F"
+		"CEAA655D0F477BFBA13322F8A4961D09B522895F3A33A812633A3D007F972777"
+		"D71FE47AB1D86E79561667B8AC6E047F06F023156D9705AAF9869283BE30E591"
+		"719B1339E30F0E9B949E1153DE1ED6F66C92731C045AAD00A44E7D94DBEE67E5"},
+	{"odd1024", 1024, 
+		"E8DD7CAD1A2FB79863B7E6C6CC32D94A23E12368DFAAB154BEAF95CCB620D9A0"
+		"1894934CFB6E77EDCB46D03F636E22C55E6B64BFB749BDEECE9AF45CB8C92A67"
+		"CED7384BF4EAC10F5DAB7E5E834C0F2571F36EC219B61D4485106FDCDED4B961"
+		"CAE9A673D45434DE52BE468A63B18A93D991A72B7BC694EB04E5F7CFCC0B9273",
+		"485332CF46424C460B48582894642262DB197976070D9CE373E5FD3D92D4ACF6"
+		"F01BE284DA524BB0C18DA816553B865EBE9CD3BD8FA97B448C6D6B799D889A55"
+		"CB578AE21FCB1C1AF92305838CB3DE7E686BDD7D02DE7B8FEAD73D3CC248C2B7"
+		"D9187E357020E2D4DE046DA91A8D5351DF0F2775289AD27D2499B980DAA57D2D",
+		"E137D07C4CEB0F0A7BFA37CC4700DDD79CEB9C348054C03E15C675D31AAE5B2C"
+		"1FD645674688BE71C5E2CE6C546D0C69619F800AC7BDAC1FBD3C346F439802DC"
+		"EEF4E7E3152E4D97038A29D1777F084653212C073433C08FEC06444E1A5817E9"
+		"1B769FF2D095CA4EB453EE7CE43DDC7A78E9B34189AAB4F342189225E0A83F91",
+		"F3719E40B126625CB9D7A3EC154274151F796F63261246FCD0AB0AA30A0A32D5"
+		"3B9DC9651AA4A09EC2AAF8EA4C5CFA6C73CBB3B916169306BE6C8D20E405D522"
+		"8FA31649F113867828C8A7F12556E66945F72A2170AD594A1064D4B75882AA6A"
+		"4C720476373EEC316530D28B325F6DB75D96DB3F5DD24266986FFF19C097193"},
+	{"ffdhe2048", 2048, nullptr,
+		"7FDB68F6D02AD5FB296DE731795A2597563960C3DDF28E3B48B02FEE09205AE7"
+		"0510A0395E93FC0B7406A809A8B559D3680B99A41DEBD2C6A65632632868A989"
+		"47B8A964A6B7E94FBD7DB297DB8C4454BD57F21E21465818D8BE0D0FC583EE29"
+		"B134C3FEA56F78DA53DBE8A93C99AAA876CCEA9B498CC5497E6A952384B1E99F"
+		"AC7B9422C95AD560FEF01E106EF876390E5B0B075D8AFCB404343A25A975F90B"
+		"F683218612AF4A33121DFF1C88CF663EB1AEBB86C1B2C7C1CD24A1E1F9877B57"
+		"2F259F0100E1766A34DD55344C677A26B41B34BEE419A449FEE0417B9FD73E22"
+		"6175515EA75AB5857A13D05D0923EA6DF26A55BE76B1B49AD027B0A23A7CBF05",
+		"29D084D41A30DE54DDD55DFF61A42CD7CCDCFB1DB6113169D51D1616D369900A"
+		"F93A5284F92B054DF8F9E53AA69E3E74FA7F557AEDD0ACA9562789498526CFA0"
+		"F158395DEE92544CD40205EE5D29807DED1ABF6EABBAA8774468A8AFFB5B0FE4"
+		"69753500F1F616D6EA7490EF958BA41AB7113F191CD2DFBB4565AFBCAB87BB48"
+		"3889DE49F7F0AC7A70FDBD7F780A1472ECFA0AC839AC0949D335CAAED78103DD"
+		"3FFA481B6C369D968135B7B5544C325AF4CDBA091E938D7E488618847FF0DC44"
+		"F854D5A31BC893C7795260D4FD9CBC712F5F4A942936620F14C3AB8AD37FB920"
+		"26223FB7D7B796C77CB3C74A9812D01276B8F0811DE5AE91CF79075CC4881241",
+		"92652E6AFFFBDF43096A2CE19BF017478B6B1E154F96A4AB90BA1906EDFB024E"
+		"37B3E997211A5AC81BE201B93B24FF87AE6D703D13C27C69AC753F327E8048D8"
+		"649559381313DE3293DEF19B789A086574BD68F92ADFBBC15FCCC913FC381243"
+		"3D097C8A3A55ED3F18412F30C4A72568697D3E232626AF7BBE129654B16FB0EE"
+		"4C5D439239A68AE5CC52D3DC8922E34150A92FC96C444DB66BD3BF714A1672DC"
+		"BF6C9F7A1B369E2428F24F4E6250979F8D2D8FC6DFC6A2F8B3160B6AB5BCDC47"
+		"B73D24AA19E3E30C11E92D0F09C64EEB6FB2B735F6636A01703B80B597980543"
+		"B68C5876FF9A65545A3E3757AB62B1E0FAD5561E808E527B4B56C22A8CA50A82"},
+	{"modp2048", 2048, nullptr,
+		"7E069E2AA8D085E9B107EC5A6BC7E5AD4236A06155BCF8C5C5769A01DF609618"
+		"1916F9E84C5259310788E8AF367AC7C7F0F17991DF459E0AB6484C15C82E8D26"
+		"DD680F083EAF7334BFF5E155A1D2829DA1DE94A7BF60A9DD9EBE49C8098D2281"
+		"187BE2089E09950F891016AE2D428429D130828C34C3074096EC25EDBFBB304D"
+		"B10B9CFCA21B11357DEEB8DA3908C8540ACD598272748141E24437284EE50C85"
+		"A1B02C11311CCEE4A5F6D09D3F67E9583C54A3EA6D11B70C9B1D1F69CBC2822F"
+		"25F603491CBE2F098FC16D42A0F403F522BDDCA9A14641E4BBC07C793F5EF6F5"
+		"9A38211DA2F2A7441CA1DB03335ED811E306046B18EA690AC700F60DC31DC347",
+		"12A381FB26BF98B888C85F4B3A6315F2F697356B8B0D47CE4CD9D0F8C0864475"
+		"F5DF9D3C423443D77072F8BFA2592C71FB8AC6B53955C04C763138E906095AE1"
+		"70F60D46C9F18BEF13E9BF7D9BCB5213A75D4833393FB92ED0BFDFA5F56F0754"
+		"2220CC912804A1E468DC009369E787D1A6DCA665CB654CA3AD8D6F870F8A6F17"
+		"0EEE46733E0379BA154E7DA56FD1E35EB734D1FEF1D8909F6006E41D8337AB16"
+		"959FACBD0EB18152533A6A734DE096A77EFF5B383E86A438F84E355E346ED0A3"
+		"EF6AE413F839E3C5B7F39DC01F93990C1146D1141CA07006D1EDF7ECD54A1475"
+		"DB156DB66E07EA06C1C34FFC12794CD9B67E9DD53B200DEC979326EFD44D8378",
+		"FB366AABF594E9564A6DC0117389A62AF62998542384F16B286DAFA0E887AF73"
+		"7D1B4155996BED1B3C58DC42F49DD02A889A874ADE4B32663AFEC55EA14032FC"
+		"F86B419A68FB726C36F3A560E75ABED303E086009F0491761B10EF6840EC4B36"
+		"3E68C15E79723649783387FAC97A7129837454676259DA531DD583C44243B507"
+		"32437C86E31B660C3B26A2ECB674FCFA559FE52CD20DC1D6DE655BB47FCDC315"
+		"1E841F86326F2397C9AED5D1C1B50E1DD0185D0EC7A08E0FFEB7A6037BC00C58"
+		"4A4DE767B106302970457C1F236C53CA97E0FD29E2D153E573FE1F086809A6D6"
+		"D6C4CA500D9F6FE60EB794A1B30109E663C324E28779119BDFAEF04BE3FBF5A0"},
+	{"odd2048", 2048, 
+		"B5185D113E483BF251BE0AA860D9D7E550B432769C81B3F59554C672B9D6F894"
+		"9084A7EA8070B3AF019C26353C68F0117759753C271C2BA61D1584A1FEC833CC"
+		"1FCD84D6F8BDFEBD9EA17FB170FD6323D4D6069B7073DC2E48202FE1B8504382"
+		"EFF17925AD56A2E06D0977179A1529C437ED536ED62BEBBD3CF8B56FEBF86DC8"
+		"FF89B19FD94C3E98D02E375DE133A82E3575A55DB256EDE3A636069216AD10C6"
+		"214F06E90A156D43DDA9278F9DEC29391CD1A0E9E0938401CD85E3F700C2ECD4"
+		"F046CD22EA39F334D345D00C543A1FC83E4FCEFEBE9CAE145B74943BD7AA4170"
+		"A236A09FAF759682844A3B45BC53D56961C6CA3484E717BC7FDFE7E949F075F7",
+		"61F6EA164F39F8A7FBF45616D6E5FB9C819D1FE9988A5A44C48507C44B8D634F"
+		"CC4E1A396843A00C77418B021F86F059CFB282DE718752FAD774ECAD7887BDF2"
+		"7C0FA4375E6B6D50B2655AB5E35AADE43D14608A9FF0BB64655C17AD4D4EC30F"
+		"A415AF0DB39F728FAD64EDA18DBE8EAE528D461699A2E1B41D64F9D4B299007E"
+		"8CE9A1B5C745194324D538FC16A1E80AFA017B4A769381DEE2F359E83C2B616A"
+		"7A4F19EA51FFEC3F2BD780CA2D09AF6A2439A05F3B718C6A95A0B0C6D318227E"
+		"70F0D69A5A4C45CFAB1E2CB59D38ABAA689479116E34E5854EBAC9E79498B2B6"
+		"DD6A3FB6640B358ABF555BF6EB49FE0B5FFDB2C3EF27C82A36A744E502D9AAC4",
+		"1E1B7B736558FA91354FFED4529732E497DC83CD711B805D88E873CEF2D3CCFB"
+		"7DC5F9B5694742F35C3FB92CC9B13862FE4A05234E7F5020B902637FA9DF01B0"
+		"EC913B4B673505D788B7F207B417B8113F9D50EA9D0924AB4AC704C9E32C0ABF"
+		"B8AB1469F92D8A89C5E1B5BB7E73630B4019A51C072E7B3AA336EFA7A40C2933"
+		"33C0F7E091A1120677B24955D637E3DDD4B835E07BBA8991C6E588C17C42261A"
+		"B3462958AFFAC85358F1A1DD933EFE8F11914201C817B3491727C4F267D62AA1"
+		"C115D375A895E3C7FB44C29F2AD73582D86A86549DA06C4DC2B7A864EABA73A9"
+		"B3CBB101DC4AAC59942F2CF8C276120D758C66F3170DB07C01D3FD49FFCF8F13",
+		"AD3394F3DFD02A3DD80A0C913DB05F554D480843700DDBED92150941B467EC35"
+		"AAF3766A74A1DE3B6DEC7AA4C940A3AD38A2FE4BC4E98E3083A57C9DCA3EFAA9"
+		"FEFA7183DB709B7778D79000D47610B5301B5CEA80E1034E46FE273F27D5B649"
+		"C24000045D029E437B4CC1D1A0CB2EC682275FC51B7246BF66DC19BAA7540E97"
+		"683265A02ECD2E75C34B6D83E4E1EA0F1AB8354702BA9243FA8FD230EAF54646"
+		"2EF96D4527CC1630B9B4AF1E268BC51A78AC2E6B483677453A9B2522658FCA55"
+		"37AFDDEE782F72003C2318DA90537AB67E98A1CF2C7954FA94BBC7E62EFED326"
+		"324293663DD14B44688422857701DAE37D86F19A43874A633E7428299725CAA4"},
+	{"ffdhe3072", 3072, nullptr,
+		"373B0ADAC30C2BAA483D0DAEF9640156EC0810996E83ECA5C7AA2E71F50145EC"
+		"851B9CB27CEF0D3086D2B91B5D1E284EBEF79BE843692331FBF2693921A737EF"
+		"918A11BF6C3BA7AED5760B2B4B325CD52D242D46C3CAB9871B6847DE403F4815"
+		"3D3476E4465CC89AEA8D6405AB8BA65941309A12CE3E13B5470E048F20C58F17"
+		"F6AD4BE0172B9A84E94D5F6DED51729DFCCA2621E5529FF7EE00EFFDD6E9EAEF"
+		"BC7B2AFBA4545C4FD5E410E9A0BEB52E51A12B863AEB8C321833B90405864665"
+		"4021E4BF3AEBAE5981CCE72906DA3C5480EDF18DE39A3E3D50EBA88B37CD9251"
+		"C78B844F3A7CCE5F32BAB3E91174E61DD57EF805976EF0EBA2858EC4AA9B56FE"
+		"71079C0D67C1A99E482B2F70076E2291864F6560845C2B0B8F2783891EE6D3DE"
+		"9748853F867BE468CA78EC561764B7CD8F1461572918BCDDC27EBA228CA772A4"
+		"167615F4B4722FA20AE03F3606DDF0D8E5C1ED789396F0558A32A911B6079E39"
+		"5F99E194872DC94B17CD00D4C400C64EEB62CBAA0312F5F83CB150B0E327E3AF",
+		"BAC1DD850FDE0FCB18F3D0940C8DE6FFFDB2BE740E2E7E700DF6E441FDDD72F6"
+		"58F40A3B4A641B2FB5E856F55BC55D222C202D0189417C420F46117EB62C753D"
+		"C375F96C29B39948C4C5F06F6B29604B5A38A5263B3544A83565793F225924AC"
+		"8C32C46D3B0044F2311E518BC512CB484FD893D8E98AE873AD4EF82FC5F65A0E"
+		"844E168EDA79F9A87A99915C8BC030EBF26C3C2D863A477A9C3595528A511C6B"
+		"E206A298A01752C87066FCBBEB1C7F3B39CB85029F8DA2F058BEED1114C98494"
+		"346D1C0869ECFE249AC43B4F8AFAF1AC2E614CFB1903D38CA2080855381271AD"
+		"2D0B10349B1E4F0888148F4815A4F1719DE0EF4CDAD4B2489EAE246736CC52C9"
+		"923DE8EF3670C3D9A9BE0A0E7934A58E4A195C59046A1D12CEAE5440F2172B4F"
+		"85E0A50FF22AA7DFEE18A7AD35558E9CA78BCE07A0037E9969BCC7548C8A758D"
+		"2B7B403D8F815FF15423DB7ABD800C87FF2AFCBE291FB403D15E62A9C9118D98"
+		"C9006F7A82010B6E2152D3B7DFEC34751C89C20EB8A0E581E18841D62844774",
+		"77E4C6C0342A679A53F296D3741BE2FD9558F2F9F89AE12E5590AC13842FDA0C"
+		"D8F31C846A83322721FF3DFF975225BC442F6CD5FA685C882A563CDA26B1AB1D"
+		"B7A8284AD38E21E02D0F323E33FD4842EAD5DF085DCF4263256F9C5E74D49E80"
+		"ADBB238A709902E72DD420D6724F67A0FF72A0B711BDDD6760835EFDF1491996"
+		"1E0A73BE1C3E7E44B64DEFA834D26D1A5DBD8830598C3C0D8A9CB3C2B5CE9C4D"
+		"98109126C35917C7DDA5ADA440DBDBCA80EF9B05FB8EC084DF58ACBFC16A9655"
+		"C421395607A8B9A8A8628429F97239DBE4D628C71D3228F09896F5B4E9DC488B"
+		"72CAAD6D11E123F125571C98531F26AE5D7161C954410EC73734A19477628AC8"
+		"168B915A46D44D78636B54CD3F78D0CFB6BCF948C5FEC02F0920FB7A40A1C10D"
+		"32C438DCBB47E71D76D5937FFCA78137602ACD51485E61C177D208690ACC84A3"
+		"5BDFF7E7F7CD0CFB067F914BD4B85BFCFCD26D3265CB40D225C23BD798B359C2"
+		"94E03B4DEB0CC0EED7652DAB738DD5D0BD36BF09E2D12D37592B6E1408A420CA"},
+	{"modp3072", 3072, nullptr,
+		"6DD54BFD209DA84837901B5B41C026F40A51F54774B2B3F1509D4442712CB038"
+		"1B31802BBAE7FED9BD9A82C64E2BAF7AAED2E1ABC75F9CDF97A5CDBA68D39255"
+		"DC7B598B3BF68A9D470CB9CC9D3A2C1F60D27971F625231DF4A5D0CF1BD2F682"
+		"5D1B540EA1F6B0ECEDB5863D097E8AADE45F07DDD6992AFA59CECEE36561BB5E"
+		"7EB0F5C62B5398C2CDF9A7B30F403EC62D624A17F80D8F949F2C92AB3C9B88B8"
+		"0556911FE1BD99F6000A2667AF4EFA5A33B790C764971ABA4064F5FB429D63BA"
+		"21D771A3EE56A5670251CBB82AFF8B809186C6AB436A35AB584384CDD24E0A8C"
+		"6DCF280D2B3A880757C3DF76C97EE54E063396065C53480CB2CFA1735A50F31F"
+		"181C382609A62EEC10F92BFDCB03F3B74912EFF1494DF72E783788F56B8390C4"
+		"8E7A4688CC96D2A56F4ED646C5BF660895426CA4339B42886BE8B761B55F42D0"
+		"01E24FE79F43487A7A72407C732F56B0A93EF48764172E37F7EE27A91B799B31"
+		"08DB4224E62FD6409F637C400BB232A9A22CC71A9E8F421C7FD2EB8C0F392441",
+		"5DC74F0CAFA63B556CF4FABC7E45EAC6C4241B9E7CFA0CB9EF2B1576FB258441"
+		"809FCF17CF32FD04D13D4465F7FE53ADB43BC113305DB7E88B06C963ED565769"
+		"CF04D5098446C76C908A9533DD010EC674A6AFB88C502CE0625267B3CC601380"
+		"90C520B33C7594917DF5C5C31794073699C20B238EAD83F805A86A5F02CCCF06"
+		"47FE4F164D487B357D5816070EE1F150B16BC4AB9C425CE1BFAECA20F5580B9A"
+		"310A993A05E680B6DAF684F4A7DBB8A3E3D89629367664A0C8AFC78B8C6C2EBE"
+		"8ACA23A5BE604228D0F31AF229BE8DF20CF9925FEE40A636693933319DBC7332"
+		"7BB29E9ADD5D58355289C6DB1A8DA7B1829EEC1F5DD20EAF4C48C55D732E43DE"
+		"788FFEAD5FF93864B05B8A6007EC013EA127EF91A0036EF8282D3ACD4CB42436"
+		"C01F74D85773157F895BF89CCD2D347CA426376263D795BA01557FDD6B96D070"
+		"A58EFB4F51EB2338EEC48927FAFBD251948F65D93CEB626C60A4482D862F47BA"
+		"C34931C7339666452B35D035F2EBBA9921F5813CFFC103D342663E0D356B652C",
+		"C2C8759758449F2BC05BE5D2E7C3A53F14E34425001316BA3534021270785FF7"
+		"8761C24EB7868553B7C6375CEB72EE37BAF6A3B2D2AE05EA75565ECC7BEAADB7"
+		"B3B6EEA477016367373BA6CED0E8134688036FD289CA7FE1A1F72ABFD299F25D"
+		"DA4F07980D93FBA2ED05E0C4306B9ACD7E90B2DA374D73DACE7933D2D22090B8"
+		"C45553E31B8D37511E5EEE739104BF13F594B7D05649712D45AB69D1BABE24F9"
+		"415564435D0071E2827B42687729A9D861B428D7EA0456C35A83E7E2BB5CDD8E"
+		"492F6BED46227CF64B3AF5D0A9DC12C6C2F5BECBA4E8E1086E1FD994130267AB"
+		"D13A0D351A2201259A1FEBFEA855EEADD0F9B834E26F00C4D51DC0B333901F9A"
+		"F807BF2F775990A6FD52378FBE496FEB4CA31C5BE6AF5BF3D20B965EFBC4416A"
+		"52BA15D0794E8CFB05FB413068D01DCA6BD6E8EBC22FAF6C89F8A83D8041D8AD"
+		"4D0411A23CEB3379EF35E68B2956027A81CE87D2A1722AF0E30363205B169DBE"
+		"028A0E65944783554852FFDE5426579A524AB01A3736671BD1EF5E2BF1C7C174"},
+	{"odd3072", 3072, 
+		"BE80AA5D0D0A35B9F198B212A9054BC95CD491EE9E1DEC4ED15720C1306A8CC1"
+		"B595BCE9B8B34BF1FE15EE444CF7B07D6282985C3C6B5E077006ACFDC95C582D"
+		"7E2F0A55BE4ED01AB0A4FD52B85EA1565CD6ABFEEC2B60D63CBC7614A5973989"
+		"208AA9B386E1F214482021145505B947362A0DDD7ACD455DFED97343FCB45929"
+		"56374D234A6DBE2425B42992E21893995BDDAF93F29E58CA1E9FBDE0479A862E"
+		"5B2DE3AC372FEC2BD0F61E33711A005BC66968AD7736DFFBDFC797BB3B5DB663"
+		"1230114FB9DF39161C89B12FE500D593863A8081DEA70CE9C799C291A21A73DB"
+		"977BB16FD843BDE479283D7F90B0762124445AEB5B6E0998CB1B464FC9957A30"
+		"FFEBCC9B571CA156EA2B73AC39061C1E6180F33212BC6A8CFB1A1F3C806F54BD"
+		"553EABF530CBAB42DE4DDEE299CE59BEE43A43E5500C69DFC3A5F607F3275358"
+		"7F7641DFBDF9722F7C7B11D52693191F15E1DBFD707A8D0B2F1C8E9D6E8AAABD"
+		"7BFC80A4AF1F4D501E09512DFB779DCC9383069CCF3664A0EEC4733F24A65A9F",
+		"9FF5ED5E4CD8F1AFB9AF3227EC0E74603F2B56D0C812D53F7BEACF62221500CA"
+		"BD1161F121FC7A62FECA151B97358FDF38702EED6F5B22E7B8F4576E5A7DEEAF"
+		"C5FF68AB91D7A5558C385EAD0C8360A958BFB3E68915A46ECDA500EC920230C4"
+		"2EA99E689AF124CCB8893DEE022E9AA03F74129FB77034967EA19D113AE69A94"
+		"2CACDC7568AAB99254767A9E6B32F4C4D5E0170E0F9C7DB19C1DC322BBD1E234"
+		"28E90A2F2359D562DD2BA4D4F8C5C038111466FFB41BF9CE21DC8DED6734C772"
+		"F134E9F08E58CC3B334BBC8C92E5A2324E8D26591B2E3F3CCEF3D4E0E3F6F462"
+		"E6301584A3565FB3764C83EEB934A85B7777B43550D703AC87B2651E1EB75D34"
+		"FA09D8A9FB15873A98A8E3CDF527429DD4179BBF7D8CCA6286473228FFFC57BE"
+		"7681CFDBA9FD4C08F9E8A9286308A63EAD78AED1371DCB7898D89DF2B7B57345"
+		"ABD84D73B70F78AD5FE5AE5CE9EDA8B6AC64319EF062F3809040145C32F61632"
+		"4C40C2CAA2DD7A6D0A1D339E4AC7E25741AAD3D4D4F9A7F0128E4ECB025D6ED6",
+		"B243739E46F2C3B2851CAB31D105E00F2FBB8290AFC68A5C3582B8D9363861D0"
+		"4E323B3ECDFB864353A753F4670773E793DBBF031850EFBEF00FAE5EE9838014"
+		"304D5EF11EDD12F3A4B54B83BF5F7A4CACF5FCC8DA59FA312562A67A27661AD2"
+		"8708E4B72B18CDE1E2D9632D4AFD4F5CCAD4831DEDB3606A04182D75F4FFDBC8"
+		"1FA7FF1BB51554C79C1E495AEA2EAAD178BBA5085FA406BB89CAE7488455E1B9"
+		"43CF889BE64868AF37633B6D5D7E043E016DD182E6215F9070E8EDEA4DDBD78E"
+		"FEB89FC7F90B41295B03E59487CE57F874EA0C5AA38784C2B6738FC2738A577B"
+		"0E8F758E1E6F57103611C5AE553065A9E7B044D2E0FA46CACFE918E0B13216C5"
+		"9A4219C5DDC775B51969A90699467212A36CE57ADA8C29A43DC809A1CAB7E41B"
+		"627FF757680259E78E48BB3968FE35DB91EDFD9A2FFA5CBABAB1FF93ED583908"
+		"F9FE6456B0B7A2B8CEE5097933A6C6530E738593160A0D554B4935A442797341"
+		"7A93CF4A9179D19E3F2FEF9A255DA6563E40188AB8414A8E54623063166059DD",
+		"3EEF584158C854386B61E9315E2030FE620B27C547081A937CA21052184780E2"
+		"7635B9A6F782C771F4FD24264A2BC82E50CBA005BB0B4482F9CF3639D174C85F"
+		"004B3D0F3306857083D5C59802A024EE73331F8AD5E117D06E090B386CFF2CDD"
+		"18D5F0E90DD5B137038D32406C07BA118AB6DCCBEA06795351F1E41827AF11F9"
+		"9CDC7BB8DFEABBE8E58BBB394F230D2BF834B811873CDA64842B9E1768AC7349"
+		"71FC109BD01FDD2BF666BEF47B4BC9AEBAAACE75710F70F7A0535CFFC5C319ED"
+		"9A1326D687D2937084C58EF0B799ECA7E62F7C4EBA8D99847015C586EF5B2FAA"
+		"51910B0BDD2E35C2FF5DD158E7244AD3FA205F837B8723226A3647AC6494AB5F"
+		"6CB25AC29C7D7EAF766E95179AEED6E7D33E600C35275953528086AC4802A9E8"
+		"35C35B6DD6D0D0FEBF922D9CEFB55438F8AFEB10E940125407B1B6B815BCA110"
+		"BDE0CA9036689EA82987D5CCB69F09BB6205BFA36EC4CFFAC5C14D917B2CF78C"
+		"C9A49176FBDA2EBB286E18E3955D69463374023465541DCD42C83F8DCB7D1142"}
+};
+
+static Integer from_hex(const char* hex)
+{
+	return Integer((string(hex) + "h").c_str());
+}
+
+template <size_t Bits>
+static FixedInt<Bits> fixed_of(const Integer& x)
+{
+	vector<uint8_t> bytes(Bits / 8);
+	x.Encode(bytes.data(), bytes.size());
+
+	FixedInt<Bits> f;
+	FixedInt<Bits>::from_bytes(bytes.data(), bytes.size(), f);
+	return f;
+}
+
+template <size_t Bits>
+static bool check(const KnownAnswer& answer)
+{
+	const Integer n = answer.n_hex != nullptr ? from_hex(answer.n_hex) : named_group(*find_named_group(answer.id)).p;
+	const FixedInt<Bits> fixed_n = fixed_of<Bits>(n);
+
+	// Named moduli have to be found, the others go through the cache
+	const FixedMont<Bits>* mont = named_fixed_mont(fixed_n);
+	std::shared_ptr<const FixedMont<Bits>> cached;
+	if((mont != nullptr) != (answer.n_hex == nullptr))
+		return false;
+	if(mont == nullptr)
+	{
+		cached = FixedMontCache<Bits>::shared().mont(fixed_n);
+		mont = cached.get();
+	}
+
+	const FixedInt<Bits> x = fixed_of<Bits>(n / 3);
+	FixedInt<Bits> one, expected;
+	one.limb[0] = 1;
+
+	if(!FixedInt<Bits>::from_hex(answer.exp_hex, expected) || mont->exponentiate(x, fixed_of<Bits>(n / 5)) != expected)
+		return false;
+	if(!FixedInt<Bits>::from_hex(answer.wide_hex, expected) || mont->exponentiate(x, fixed_of<2 * Bits>(n * n / 7)) != expected)
+		return false;
+	if(!FixedInt<Bits>::from_hex(answer.short_hex, expected) || mont->exponentiate(x, fixed_of<Bits>(Integer(0x1FL))) != expected)
+		return false;
+	if(mont->exponentiate(x, FixedInt<Bits>()) != one)
+		return false;
+
+	// Conversions: lower case hex without leading zeros, big endian bytes,
+	// and numbers that do not fit rejected
+	FixedInt<Bits> parsed;
+	string hex = x.to_hex();
+	vector<uint8_t> bytes(Bits / 8 + 1);
+	x.to_bytes(bytes.data() + 1);
+
+	return fixed_of<Bits>(from_hex(hex.c_str())) == x
+		&& hex.find_first_not_of("0123456789abcdef") == string::npos && hex[0] != '0'
+		&& FixedInt<Bits>::from_hex("00" + hex, parsed) && parsed == x
+		&& FixedInt<Bits>::from_bytes(bytes.data(), bytes.size(), parsed) && parsed == x
+		&& Integer(bytes.data(), bytes.size()) == n / 3
+		&& !FixedInt<Bits>::from_hex("1" + string(Bits / 4, '0'), parsed)
+		&& !FixedInt<Bits>::from_hex(hex + "g", parsed)
+		&& !FixedInt<Bits>::from_hex("", parsed)
+		&& FixedInt<Bits>().to_hex() == "0";
+}
+
+int main()
+{
+	int failed = 0;
+	for(const KnownAnswer& answer : ANSWERS)
+	{
+		bool ok = answer.bits == 1024 ? check<1024>(answer)
+			: answer.bits == 2048 ? check<2048>(answer)
+			: check<3072>(answer);
+		cout << answer.id << "\t" << (ok ? "ok" : "FAILED") << endl;
+		failed += !ok;
+	}
+
+	if(failed)
+	{
+		cerr << failed << " FixedMont known answers wrong" << endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,270 @@
+// g++ -g -O2 -I. -I/usr/include/cryptopp test-montgomery.cpp -o test-montgomery.exe -lcryptopp -lpthread
+
+// Known answers of MontgomeryContext, computed independently with Python's
+// pow. The moduli include widths whose word count Crypto++ rounds up in
+// its MontgomeryRepresentation: 1 word to 2, 17 and 18 words (1088 and
+// 1152 bits) to 32, 24 words (1536 bits) to 32 and 48 words (3072 bits)
+// to 64, so that R has to be the one of the representation.
+//
+// With x = n / 3, y = n / 7, e = n / 5 and w = 0123456789ABCDEFh:
+//
+//   x^e mod n, x y mod n, and x^e y^w (n - 1)^0 mod n
+//
+// Exits with 1 on the first wrong answer.
+//
+// Usage: test-montgomery.exe
+
+#include <iostream>
+using std::cout;
+using std::cerr;
+using std::endl;
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include "cryptopp/integer.h"
+using CryptoPP::Integer;
+
+#include "cryptopp/nbtheory.h"
+using CryptoPP::ModularExponentiation;
+
+#include "named_groups.h"
+#include "montgomery.h"
+
+struct KnownAnswer
+{
+	const char* id;
+	// nullptr for the named group of the id
+	const char* n_hex;
+	const char* exp_hex;
+	const char* product_hex;
+	const char* multi_hex;
+};
+
+static const KnownAnswer ANSWERS[] = {
+	{"modp1024", nullptr,
+		"2FC52181DA6566A992B132190572C26B8BB0B7198703F5EFDEAA1C6932EDED08"
+		"75255B6B1BE47FED96C129E26DBE1B19AC8197D951A3ED0625D2E5FF582F4595"
+		"1E00358D945C69B19016964A993A8C8C25C0E8FA2D1180D71A12064102C8967C"
+		"0F83E12D90EAF8E548246D5A6EB86EE1F1E19B4538C583BB948E5044C808E1A8",
+		"9249249249249249052DA18137A9938BDE28384FB7593509CE4A75BBBCCD9966"
+		"DC98FF3A6AE6A1CA779804D7BEF9275A3FC2EA1D99D82658ADCF73AC8A7F7944"
+		"2DA54319F5534A7114DEB0D5EF116D03F950263C5EFB6318992434FAD4961FF5"
+		"ACB286D8C6057FCC63C8A6E56B98A4839784CCC119A82FB80000000000000000",
+		"AB2EF190E66B26F9C38D1980692CF85B22573515100E0A2F7D11B157FC0DE2AF"
+		"A245B223139B3BCDF3BAF76753FAEAD6A6F48587BB2A90AA662E11F072144B71"
+		"7FB2595802E46F065FEA81C988235C09DC07FDFDD53903ABFBB77A758590EBC2"
+		"024DD0671039E8F558B63BEF9BDE8648AFE4182DDEB1EDC86EB9591A6386F9AE"},
+	{"modp1536", nullptr,
+		"5596E79B17EB87B6A0CAD314993EA5845AE2FFB1EBB585E5C0AC149056267C9D"
+		"D2A1621F6DB66B9D1ED5EE8D36B8DE78DBDAE1D9C50CC02DE489BA1C971E7E76"
+		"5081223F1D6584C4C86772CAFE81F98CC9AD16F61944DF97B4482EE94D02FBE1"
+		"7B89639A88E4D1E08CA9ACB8D2A7FD7A06FE914F08908259723C82A77EAE72F2"
+		"0F3E632A568F8E070973E9CCA1C0BDDC6418673B50632D2E0364C7FCB6898F0A"
+		"8E268FED2C615441EA82324018B5A50E482E76CCEC7169F96A28B1D2F974F785",
+		"9249249249249249052DA18137A9938BDE28384FB7593509CE4A75BBBCCD9966"
+		"DC98FF3A6AE6A1CA779804D7BEF9275A3FC2EA1D99D82658ADCF73AC8A7F7944"
+		"2DA54319F5534A7114DEB0D5EF116D03F950263C5EFB6318992434FAD4961FF5"
+		"ACB286D8C6057FCC63C8A6E56B98A4839784CCC119A70F910124D98E13146D27"
+		"C50F04B134C354583C0CB6A9B5399B1201F0C78234EFD0E810388B0CA4DE786B"
+		"3630A9BB1BC3C3AC3AE2679A73D97B7089F9624E2A5D66600000000000000000",
+		"B3E773C094D9EDAAC8A235E75A4A34762A3AD048C6C8AE15A2E5699B044E92AF"
+		"7C1000BAAFB805C7217E57D956A6690AA199998465E3D7F54C3E4EA6F17F3709"
+		"211B2F8D02318DDCC9E75CE966B1CAAA3EE59B8D7723C9B767F24F1275654D60"
+		"C96EFCDB5220D2782F10C9A79FB0EE091DC192145F999794962C781AB1FBAD37"
+		"03C79724D8A48EEBEC69CA4209CB347D3DD07FA56477F6098E50E310995260D6"
+		"153FE2C3FAFB72A132CFF9D980C2FDEC3D2977508FE2FC1C1CA3E039EFECDB3B"},
+	{"ffdhe2048", nullptr,
+		"7FDB68F6D02AD5FB296DE731795A2597563960C3DDF28E3B48B02FEE09205AE7"
+		"0510A0395E93FC0B7406A809A8B559D3680B99A41DEBD2C6A65632632868A989"
+		"47B8A964A6B7E94FBD7DB297DB8C4454BD57F21E21465818D8BE0D0FC583EE29"
+		"B134C3FEA56F78DA53DBE8A93C99AAA876CCEA9B498CC5497E6A952384B1E99F"
+		"AC7B9422C95AD560FEF01E106EF876390E5B0B075D8AFCB404343A25A975F90B"
+		"F683218612AF4A33121DFF1C88CF663EB1AEBB86C1B2C7C1CD24A1E1F9877B57"
+		"2F259F0100E1766A34DD55344C677A26B41B34BEE419A449FEE0417B9FD73E22"
+		"6175515EA75AB5857A13D05D0923EA6DF26A55BE76B1B49AD027B0A23A7CBF05",
+		"3CF3CF3CF3CF3CF3BBB507E45781ED31054CD78DC03326E43FCAB51F61DA00CE"
+		"4D04DC27E0489EA9AA9D0D3114E802CDB01797A9F302F77CCCFA4EF472C10B04"
+		"DD1CBE32E9CE9E3BB34952BE5393D13DD69DC2CB2720129B8CB3355FA46A3C18"
+		"F380890EAF73D8105A892D035EA6D5D20721151A31971EAB23F860EE4E264DAF"
+		"821AED4FE182B5C1F4D14CE142F2E0F2CA9F89689D273A312B8CC6B94D4A98A7"
+		"F8BF5D3717AD9A42EA3EC66CCAF64AD1ABB7918B18A8BC1FFD0031E7B43D2FDA"
+		"4733C2B7A5508D24773765DB5D76B11F5F6D4B067FE9D3F6DD7479209D6B2C32"
+		"22D8E42B7F4E80E16C524E9B8373BF3BA693714A60468FF36DB6DB6DB6DB6DB7",
+		"26E246D9A5DE0D2968CDC43263BFF60401B33E79B0C7338F6E6D52F3035F292C"
+		"B00C5D61B88F40CC833E636A10DBBC66AB651B9A79D0BA8798FF26E715E3E739"
+		"2E0069533C595D1BF1C34CC62468EAE3D798246071019916DE37AEA132D0F886"
+		"00BD69FBA7552E14E7822F24984528FC0B6316087BD064BCFFA1CDA8602B07BA"
+		"184A8186B34AC152BDA3C9651C0881B0896806A2AA365173B4B791E18B3399EE"
+		"F3E59E47D95B877DE93B0E27B7CE2D4346012DAE62E4A21C4468B7F672804039"
+		"2F24FFECE4AB1A24F7983280F829607D22130BA6993B450D3C41B1F1BBA85D33"
+		"AE740E5DA1879CE330A9B30E985A98ECA32AB4D402D1CCE4825B41F03FA007DE"},
+	{"modp3072", nullptr,
+		"6DD54BFD209DA84837901B5B41C026F40A51F54774B2B3F1509D4442712CB038"
+		"1B31802BBAE7FED9BD9A82C64E2BAF7AAED2E1ABC75F9CDF97A5CDBA68D39255"
+		"DC7B598B3BF68A9D470CB9CC9D3A2C1F60D27971F625231DF4A5D0CF1BD2F682"
+		"5D1B540EA1F6B0ECEDB5863D097E8AADE45F07DDD6992AFA59CECEE36561BB5E"
+		"7EB0F5C62B5398C2CDF9A7B30F403EC62D624A17F80D8F949F2C92AB3C9B88B8"
+		"0556911FE1BD99F6000A2667AF4EFA5A33B790C764971ABA4064F5FB429D63BA"
+		"21D771A3EE56A5670251CBB82AFF8B809186C6AB436A35AB584384CDD24E0A8C"
+		"6DCF280D2B3A880757C3DF76C97EE54E063396065C53480CB2CFA1735A50F31F"
+		"181C382609A62EEC10F92BFDCB03F3B74912EFF1494DF72E783788F56B8390C4"
+		"8E7A4688CC96D2A56F4ED646C5BF660895426CA4339B42886BE8B761B55F42D0"
+		"01E24FE79F43487A7A72407C732F56B0A93EF48764172E37F7EE27A91B799B31"
+		"08DB4224E62FD6409F637C400BB232A9A22CC71A9E8F421C7FD2EB8C0F392441",
+		"E79E79E79E79E79E4832EA61ED77299D751503D38CF7E94F86A08FBE959ADD8D"
+		"87F23EC72942802B3D5B5D0043B528F98F9F480433963CB7133321D1309F2AAB"
+		"F2F054E919C3E088610B42A80FDB97464ABEE734EBB8B23C47CEA937D0985D44"
+		"FC1AAAD73988B5039DFDB2EB3FB1AF25AFE799871348835041CFADCB9E35ACD4"
+		"4D57C76DE8DFF0365F1421375EF08ADC83129138D3D10AC4C45986D4050AE954"
+		"6B226212EBF5F5D0B2912409E21858C7852030FBC309A4642DBF923F7F256542"
+		"603A0A4C774A17BA1EA9D89F9899318E36BEC2B4F6FBE9614F1B6F6531C99AFD"
+		"896EB0341131DA9E8174FDE57E378AAD0736E251EB2CC9E02EFD76611C48D016"
+		"5B5936D87487B4D537EFC17DD67DD8467DAF8B1E47F94840F7D1D117663A1822"
+		"5EA154C89569D991DEAFF46967A7EA9AF82374FDE781E3E7C1D612FA01C60798"
+		"318F578CD7479D3631EB7021FCDD1CFF54A7151E6288DA9F165DF5A22F261B8F"
+		"8E221748083D8281E80F9C5EB32E1B2B68E4128B43C781C3DB6DB6DB6DB6DB6D",
+		"D7A6A86431CAA74DF80C4DF12E2B5B5B87F0974A8CDB945655B13DBBB7826C70"
+		"3B49BACEC6D92B89EEB81317C9356929724266B5F834C56EAB46B6ACFD8285D7"
+		"AE6BDB75A9F37A5E8B00B1415A85F28D3E6FAFD94B437ADCD025FA7CC47F4B37"
+		"4B01C1EB0F13896F9009577563A7B9E202C87A73A326CBCEF69B741F50EA751F"
+		"82151B4AAE3624257E4FAAA1B762880D28A54C68B9988AC3E275381DA5B166B8"
+		"244D292A582BCADA0D343B06DD97BC8375FF230F544E37FE5E7E79A8B36076D5"
+		"F0CFBE6C6A471845C3221C1F9B70AF29A5578EE154053DD1ECC8E4B3B7A75000"
+		"5818B39B402ACC0BC3F730B529EC96F3D3D987C174EB10D5016E91576490BCF3"
+		"B8C07E0788D4C4ADEE64B1364A05209BB0B5CE2541F3E82A2D6EF0120235A740"
+		"039BDF620DD6D0C32088B493D5478D9FE97C44DB3C14B96C35A173C916F43755"
+		"6A6F96B3E18872422DD3CAEA7A56B3BBF6A30626823860C6FEBBD99C857999AB"
+		"51C3E67EE6A9EBEAD7D1F95A835B6958F30106FAF408E228CD9E93BF48782261"},
+	{"ffdhe3072", nullptr,
+		"373B0ADAC30C2BAA483D0DAEF9640156EC0810996E83ECA5C7AA2E71F50145EC"
+		"851B9CB27CEF0D3086D2B91B5D1E284EBEF79BE843692331FBF2693921A737EF"
+		"918A11BF6C3BA7AED5760B2B4B325CD52D242D46C3CAB9871B6847DE403F4815"
+		"3D3476E4465CC89AEA8D6405AB8BA65941309A12CE3E13B5470E048F20C58F17"
+		"F6AD4BE0172B9A84E94D5F6DED51729DFCCA2621E5529FF7EE00EFFDD6E9EAEF"
+		"BC7B2AFBA4545C4FD5E410E9A0BEB52E51A12B863AEB8C321833B90405864665"
+		"4021E4BF3AEBAE5981CCE72906DA3C5480EDF18DE39A3E3D50EBA88B37CD9251"
+		"C78B844F3A7CCE5F32BAB3E91174E61DD57EF805976EF0EBA2858EC4AA9B56FE"
+		"71079C0D67C1A99E482B2F70076E2291864F6560845C2B0B8F2783891EE6D3DE"
+		"9748853F867BE468CA78EC561764B7CD8F1461572918BCDDC27EBA228CA772A4"
+		"167615F4B4722FA20AE03F3606DDF0D8E5C1ED789396F0558A32A911B6079E39"
+		"5F99E194872DC94B17CD00D4C400C64EEB62CBAA0312F5F83CB150B0E327E3AF",
+		"E79E79E79E79E79E2FAFEACA19541EED7A8A664DDA5BFA30259BE37740A2CFDC"
+		"BE45AAFDEDE0C1518854CBBA82A4D774038CD9EC350B460D7150C5A0E743F6AC"
+		"1506D2C178778C7C7616A0D33D981B1E2F8AB103FB1379E8B042979EA3FA1792"
+		"03B53C049AB8350AF1A2DE400146C61E1B175030560B0E23EF163D2328F7F401"
+		"54CCB8FC58F0B2ADD581BDBE64CE239A9B91708D8861DD213F16F3268C1B774B"
+		"17A3FBD159FA16FE46EE8B9D69A7E91CBFB98F76F74DFE1327CD8A7079B54F70"
+		"A82B172040FEE5242B6C1CA7FCC30777376C1D18B2DEF243AFEDCC48BC97418B"
+		"51382FD87D5D83589B9F2AB559EB09E2AC30481AA10466BBA4796AEC986BF6D9"
+		"17FF26B15BBDE9A0B9EC652454B86CBD9FE901FE534E11149A29F575290019C4"
+		"9E539751C18B9CDFDFE07917F37A00016FF156329C79A7F0060052ADD4D1BEAA"
+		"16E70882E308D2F14C320307B13D40B709201233D56E1DA0C594F948A906EC15"
+		"D8F3F9864402BC9B7F86425DA77820C5A860ACAD5CFC72F5B6DB6DB6DB6DB6DB",
+		"79DB4B6E8536B50F4EF398FA56B53D8AD31E1581C8B6893B2BB76B2282B4696C"
+		"9D010386F2C77C12CA6070DA982B1AA1C084BF1BD2DDD4E1C75E2D9260518FBB"
+		"8D911FF69B9C59A4339309336106D7B95FC0A83442FBB1EE7CF901BE207DE77E"
+		"6B90E40861AEFB29E76754E0B4AA8F62FEC0C609593489B14B7120FABAC1C081"
+		"8D50988939C7C5B453250E2847B03F3BA140E3774F053AD0A08EE9DC223AD60D"
+		"8A41EF56B2E9B9C139210F2803DC4D5F176C00020C9FDAC53705E888194C3204"
+		"EF9A67976490D5A3C2BECCB9B92008FA92919F507938EAC0D8B49574F77441AE"
+		"930B0BB3618041A61E916392E4AB8926EBB79154D2FA8E6E491AE63BC626DFF8"
+		"A95B1A53EBB6CE4A16EFF447E83476BD1054E2A38872C996B670DD7B998D0F93"
+		"A3B92686C9EE6D2F5E6E59137F9E2B82B599DCB267A5B9DC072DEC4921AE27AB"
+		"94D4EC61D6C6D78C1484DD386FD7745411D06D0E0BB4B58AB295516F38D5057E"
+		"9E033A81157D0A3A2DA39F1EBFDAC22FA270F68CE06D2F7A5419D26E12A24055"},
+	{"odd64", 
+		"9FF63C0179E58219",
+		"768A20EB765399FF",
+		"90BA364A7A7A5123",
+		"8B615CC307E70E91"},
+	{"odd1088", 
+		"F0010C962F10291E61D8BA065DEBB60932D2587E7C74E5BF5DE955014025DBC0"
+		"0598FE2510329A9AC8C0868E24C86CDBA3C2A12D30A70FD15D1F317816A2E7DB"
+		"EED3417942A77DEA8BFF1EB559302CAC59EBD4F4CDF0A50FAAA0A2DB40B0825A"
+		"50B6E64223E15490CF9E9964FA88CFE96A9E483E56218C987C6E279080C5C716"
+		"A8265A49889B0931",
+		"7621C8C4407B5F3EA91CDCA214A15919B0BFE4C7B64CBE397990B82B2A5F85CC"
+		"6F3AAF4DF2F6AEAE14BC04C24DDFAE3883EDCBBB92280E7EAEF772E18A22FC3A"
+		"FDB079A3629282AD28250D19AA295C1DCA451204C7D97867FE3D11D68C2D7854"
+		"1B7E8DB194CEA747390B327337373676397AC910728C201DFA4E3D2FF006E3F1"
+		"5B1FC9A49AA3EAB6",
+		"89252BC3889B8535EEC4FC95EC86B129D3E5E96CD9675EB67ECE79B7925EC6B6"
+		"DEA09139C01CEAA197497175CBE03E345D93C9D0AE16522E7E5AF7B25613F234"
+		"8878B7B3018447F3BDB65AB0C54019870ECFE767511BCC08F3C981A1DBD293A1"
+		"52B1A825CB5C3052BFC857A76A97523C3CECBB9155CA0732903EF2096E27DF7A"
+		"A93A7CBC4E0F72F8",
+		"DBEC82D085A1B78D17AD4CFB8F52A5729384CCCD341B3F9FB8447116EE8B912B"
+		"9B3726E4B8FC466844F0EA9C10C52CC2E23E91631FD44DB38BE4980792DEBC8C"
+		"DB249C6568BC9886EF344A066D218CAD4B06DDACC24EDEC0C9AD65B9F313CF69"
+		"7211A487992FB75AB4593F1BAA532C98606AEECD9C26E81020B1D8D86EF33C8C"
+		"E02BFDEABC7D57A6"},
+	{"odd1152", 
+		"CBAECC011004DEB2660B266A1A2DCD21FED3F10DA6A75B0F476FBD425856A1A5"
+		"1EECD04D7637A390419A9CCBDCB784CA6D02F2A9C695CB7C7768B369918E3C0C"
+		"754A40B66DF797D4D53DA18D7123CCCFF73BC45BDDD25D9D7034FAD67F234C10"
+		"9143138AE0DAF2B2C376239CB6615E240FA1423E7F4B48705777EF36EE7BC0EF"
+		"165CA1BE9F5A522E9338B16B901F8089",
+		"4BB33A9192C6F4B38E629855AAA13DBEA87F56EF68E3846CCEF69D0BF8F413E1"
+		"B9675E0D2B044B5A66195C72570889E88D8775C94F89230B28A55FEE3197A5A8"
+		"CBD24546BA28F96279D9990A4C6E954120B1E7D60E685923C79F8090DE1BF935"
+		"0D11833496D8B869D84ACD425B1C476826F0F57B267DE624A0346E2247AA29D8"
+		"CA907C24B6485EBF5A1958CEC05DD865",
+		"C1FBCE7AEAAF4DFF3C9CE7A2008D24E36C99165624D025F62BA75EE9DA3A200A"
+		"F8E1896E5834FD4C6F3DEAA9C6041CF18C6454D273FC6045C70E61B9DFF52CFF"
+		"ACA83DA18D4D53A6206B7549C115E7A17DBF0426BAE0BAAE527B998F548323DF"
+		"043FE1D999320BB67102CC953FFB351627443F16F323206AFDF85189A62CB7BF"
+		"217CCACDED191150EDBC16AF957355D8",
+		"8D9A690B150FB005D2534E17D95B256282545A71569E753D20AE6F8AE965F92D"
+		"F203B5D489C1BAB20E633CF3223F888450C44E8E8A0C0FA3A4E6A44577B6099C"
+		"AFC90CB87CFC7C9D758F659F09BA2BB7C05E3038CFE2EBB9F746FF0BEB719DF9"
+		"6938820BE077B3F499127442BCC7FA54E1DC67E534FA8CA6E5B08457244E93B8"
+		"6EDFB2CF90495B35CED19A42B198BD31"}
+};
+
+static Integer from_hex(const char* hex)
+{
+	return Integer((string(hex) + "h").c_str());
+}
+
+static bool check(const KnownAnswer& answer)
+{
+	const Integer n = answer.n_hex != nullptr ? from_hex(answer.n_hex) : named_group(*find_named_group(answer.id)).p;
+	const Integer x = n / 3, y = n / 7, e = n / 5;
+	const Integer w = from_hex("0123456789ABCDEF");
+	const Integer expected = from_hex(answer.exp_hex);
+
+	MontgomeryContext context(n);
+	auto cached = MontgomeryCache::shared().context(n);
+
+	return ModularExponentiation(x, e, n) == expected
+		&& context.exponentiate(x, e) == expected
+		&& cached->exponentiate(x, e) == expected
+		&& context.exponentiate(x + n, e) == expected
+		&& context.exponentiate(x, Integer::Zero()) == Integer::One()
+		&& context.multiply(x, y) == from_hex(answer.product_hex)
+		&& context.multi_exponentiate({x, y, n - 1}, {e, w, Integer::Zero()}) == from_hex(answer.multi_hex)
+		&& context.multi_exponentiate({x}, {Integer::Zero()}) == Integer::One()
+		&& context.arithmetic().ConvertOut(context.one()) == Integer::One();
+}
+
+int main()
+{
+	int failed = 0;
+	for(const KnownAnswer& answer : ANSWERS)
+	{
+		bool ok = check(answer);
+		cout << answer.id << "\t" << (ok ? "ok" : "FAILED") << endl;
+		failed += !ok;
+	}
+
+	if(failed)
+	{
+		cerr << failed << " MontgomeryContext known answers wrong" << endl;
+		return 1;
+	}
+	return 0;
+}
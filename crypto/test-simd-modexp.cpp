@@ -0,0 +1,166 @@
+// g++ -g -O2 -I. -I/usr/include/cryptopp test-simd-modexp.cpp -o test-simd-modexp.exe -lcryptopp -lpthread
+
+// Known answers of simd_exponentiate (simd_modexp.h), computed
+// independently with Python's pow, for every kernel this CPU runs (the
+// scalar one is the MontgomeryContext fallback). Over named groups up to
+// 4096 bits and an odd modulus, 11 items each, so that the batches of
+// 4 and 8 lanes end with idle lanes:
+//
+//   item 0   (2n + 5)^0, a base that is not reduced
+//   item 1   (n / 5)^1
+//   item 2   (n / 7)^1Fh
+//   item i   (n / (3 + 2i))^((n / (5 + 2i)) >> 37i), exponents of
+//            different lengths side by side
+//
+// The known answer is the product of the items mod n; each item must
+// also match across the kernels. Exits with 1 on the first wrong answer.
+//
+// Usage: test-simd-modexp.exe
+
+#include <iostream>
+using std::cout;
+using std::cerr;
+using std::endl;
+
+#include <vector>
+using std::vector;
+
+#include <string>
+using std::string;
+
+#include "cryptopp/integer.h"
+using CryptoPP::Integer;
+
+#include "named_groups.h"
+#include "simd_modexp.h"
+
+struct KnownAnswer
+{
+	const char* id;
+	// nullptr for the named group of the id
+	const char* n_hex;
+	const char* product_hex;
+};
+
+static const KnownAnswer ANSWERS[] = {
+	{"modp1024", nullptr,
+		"A93FD922A6D7DB052131AF93B3C6880160430BF9BAD3511783BBFF4D718EA3AA"
+		"E1B6F3F5DD1CE4A7CE7323A706A6301E22E9826060B5DF143204BA9629D7741B"
+		"5A0CB293E207CE402A0E0D0A17D918A5BA38BE3643D1C826DF24F7B1EF3F9D80"
+		"00F0485C6121D1F5411DEC1572BEA9308FFB2DB0AC15B33064049CFEE3373202"},
+	{"modp1536", nullptr,
+		"9F907C947C040F0458E071EB2BDD0659A68CE89598A145F1C9B0C0FF78AD8BA0"
+		"E5E08F82F850F58265C0C12A12962004069BA3FE65F41A01A5466157C3330DD9"
+		"0F49938A00FC77F320EEBDC161B9CAAFB3FF5250936B0CD013C5F91B0ABB3B28"
+		"00ADC1297697DAB356C840B9052FE6B63ACB73F7DC6580D9617A0CF3A428756C"
+		"99E7E7048DA6306585EFF862261CCBF1CBDB87CE0013F17F3492832B9E8C8850"
+		"1D74CD3D90AB02303B9057FD3CB94B6773F4C8FDBE4057463E49149502FECC27"},
+	{"ffdhe2048", nullptr,
+		"89FA192AFCFAB435341A0A2C10C653A2B3AC28575B8D196596A594B976C5592E"
+		"CB533749B8E62834961D713278C6218B436CEB06D47E0915B952540461B8D843"
+		"C5AD01314118092BBC982BF40A2513DA63186E779FE4901456F2F1E0870E7285"
+		"B5436390B9CDEC41BDB2A05E714EC16A006B59B4595CDD1BEB437D1F7C56E230"
+		"C74A16FF68D69F195AB7A67B83DB54AE4CE6BA655422CDAC448CD17170CB95E0"
+		"23756DD7872EBC1B7345DC7DF01980AFB5082448A2A2A52B8D238A968F194D09"
+		"398CF1C72A688E58F57F570C56A2BAB78C1F5767BF8477C5F7A95EBE85188899"
+		"43F4600A11C54314C08620636ED9E56EFDE0F255215187D06C194D0DC9D195A5"},
+	{"modp3072", nullptr,
+		"1110DC531E3B583AE3A0E0AFB74F887FF3E14E60D6CC1ED93DFFC43BC93E8AA2"
+		"BBE91D74F6AB279659B03830A90274079C66E0C0F67552DA412E3B3DCCC7E692"
+		"B87852D746212F40AE612B25E51B5837CECFA667F4ECD0E4B887A6D157712B27"
+		"F9BC35EB4F2C65B75AE70859E8ED16D7446995E1294B316454F80391B05E4E20"
+		"BF76A2E6BAAFAE862EEA2E9021E39EAA5B943F8DBA5DE93C96A4340A1C35C79F"
+		"5BE39BA4455903E849AF1729AF35E1327EC200F110263E2C1D9AAA36C5EEA5DE"
+		"0D00A8240336CFBAF8B0F61BF4650B5C725542EB6D314ACCBFBDB27BD7923D61"
+		"6076E7B3984A1A9C66F97D83981B5AFBACA6B01F941DB1FE90831E22F3B7D3BB"
+		"F7FAF266E6B130DDD39EC1FB24BB75F2CAF8A88EB34D7BA380280708C8B8D3B4"
+		"419F8226EAF898A62EF16078D588952E58AB8E4EAD33B4803172F29474AD3EEB"
+		"04A9D7C361900F75F6053348EF411EFF76627D863AA774672DF0CBF8585F439E"
+		"4C0BA2B0E62BB61E2F46C4C649A8423D58E2CCD8A570BD2C3DD52446BE2A42B8"},
+	{"ffdhe4096", nullptr,
+		"3871FCF00CF77DDD58E40CF9EAC1976AC1DAEC655CB389231450752E81788E47"
+		"A5E5B6D2D28EDB5CBD968098D0D250F5C4FB11E400ED7DB778F9D0F5EE3BE1C1"
+		"593E0665028256CA01F7713878B3E2FD2B722027BACB7044E7571D73F9D44FC6"
+		"B6C6C709766A45091D3F07ADA5454FF31D07B78527915B5950673BC4FEAACD4A"
+		"6AC1E2A9F86E34109AF28BA30A4EBEB73EB5FACEEFEC8FA73669899383A2CBBF"
+		"55BCE175536D4A22A890B2E2601E3B6E1B80536BDC207E930538634BAB182838"
+		"295D8C8547BFF2DF08B2835046ED7079DF3E168286D7A410B23EA98C6881716F"
+		"FE1C6168CBD5098472E4E99A099101A23FF319D85110811CAFC68FD608C5956C"
+		"976C1CBDAE2FB45FD71EEE4DAFBC7BF982275758267EBE65807925ED4E38A72E"
+		"4773C5A6C02AD2B43EB504EC882738B0D1E5ECC34C2806728F111690ED2B19EA"
+		"DE18B6C0C71749FB64FACC14129C8E0F127ED06A396B946319B9D9B76CF1D30F"
+		"A9A96F3C44D4687E173357A77EF3C6849FA948CE5FEF695CDF9E53954D240D57"
+		"1CAF937E37D3EBE1BF9BC50D3AF8EEA15AB78827DCBCAD2B639B21DF50E3E51C"
+		"E9DE1518638B1E63E71DD83DAB0752C1F2EDDA6E42BDE8FBD0830433DF9A53BE"
+		"51A36AF0DC6DC80CF517BF72A64B0C242D1865AA34B7F699488EE5833DA2E900"
+		"1EA9B2B0FE8C2110E7AAABCA7E37311A0421411E72BF1F246FB86287E6D650D5"},
+	{"odd1088", 
+		"F0010C962F10291E61D8BA065DEBB60932D2587E7C74E5BF5DE955014025DBC0"
+		"0598FE2510329A9AC8C0868E24C86CDBA3C2A12D30A70FD15D1F317816A2E7DB"
+		"EED3417942A77DEA8BFF1EB559302CAC59EBD4F4CDF0A50FAAA0A2DB40B0825A"
+		"50B6E64223E15490CF9E9964FA88CFE96A9E483E56218C987C6E279080C5C716"
+		"A8265A49889B0931",
+		"81E50496FABD4EF516553C1A76064830ABD43FA79920B356D11E786DD981E93F"
+		"1FF34A063B05931E3E70D368DD6B47489D46BC92011B83AC641D9A1681B0288E"
+		"616AC34EB919DD57D4FAB660E161938B454AAD2E172D22ACA402C71EB331BA18"
+		"A7ECA20DE8AD42EA17DDFF2DB70C13A06EF872F3581830CBC06B0FE3063FE6BC"
+		"CBE091950C0999C6"}
+};
+
+static const unsigned int ITEMS = 11;
+
+static Integer from_hex(const char* hex)
+{
+	return Integer((string(hex) + "h").c_str());
+}
+
+static bool check(const KnownAnswer& answer, const vector<SimdKernel>& kernels)
+{
+	const Integer n = answer.n_hex != nullptr ? from_hex(answer.n_hex) : named_group(*find_named_group(answer.id)).p;
+
+	vector<Integer> bases, exps;
+	for(unsigned int i = 0; i < ITEMS; i++)
+	{
+		bases.push_back(i == 0 ? n * 2 + 5 : n / (3 + 2 * i));
+		exps.push_back(i == 0 ? Integer::Zero() : i == 1 ? Integer::One() : i == 2 ? Integer(0x1FL)
+			: n / (5 + 2 * i) >> (37 * i));
+	}
+
+	vector<Integer> first;
+	for(SimdKernel kernel : kernels)
+	{
+		vector<Integer> results = simd_exponentiate(n, bases, exps, kernel);
+
+		Integer product = Integer::One();
+		for(const Integer& x : results)
+			product = a_times_b_mod_c(product, x, n);
+
+		bool ok = results.size() == ITEMS && product == from_hex(answer.product_hex)
+			&& (first.empty() || results == first);
+		cout << answer.id << "\t" << simd_kernel_name(kernel) << "\t" << (ok ? "ok" : "FAILED") << endl;
+		if(!ok)
+			return false;
+		first = results;
+	}
+	return true;
+}
+
+int main()
+{
+	vector<SimdKernel> kernels = {SimdKernel::SCALAR};
+	if(simd_kernel() != SimdKernel::SCALAR)
+		kernels.push_back(SimdKernel::AVX2);
+	if(simd_kernel() == SimdKernel::AVX512_IFMA)
+		kernels.push_back(SimdKernel::AVX512_IFMA);
+
+	int failed = 0;
+	for(const KnownAnswer& answer : ANSWERS)
+		failed += !check(answer, kernels);
+
+	if(failed)
+	{
+		cerr << failed << " SIMD exponentiation known answers wrong" << endl;
+		return 1;
+	}
+	return 0;
+}
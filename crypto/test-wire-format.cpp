@@ -0,0 +1,156 @@
+// g++ -g -O2 -I. -I/usr/include/cryptopp test-wire-format.cpp -o test-wire-format.exe -lcryptopp -lpthread
+
+// Known encodings of wire_format.h, written out by hand from the
+// MessagePack and CBOR specs:
+//
+//   requests  bin / byte strings (also CBOR tag 2 and chunked) decode to
+//             the hex of the integer, CBOR tag 3 to the negative one;
+//             text with 0xff, and the JSON "\u0001..." that used to pass
+//             for raw bytes, are not integers
+//   replies   only what wire_integer marks goes out as an integer, other
+//             strings as text however they look, and every reply decodes
+//             back to its JSON
+//
+// Exits with 1 on the first wrong answer.
+//
+// Usage: test-wire-format.exe
+
+#include <iostream>
+using std::cout;
+using std::cerr;
+using std::endl;
+
+#include <stdexcept>
+
+#include <string>
+using std::string;
+
+#include "json.hpp"
+using nlohmann::json;
+
+#include "wire_format.h"
+
+struct KnownRequest
+{
+	const char* id;
+	WireFormat format;
+	const char* bytes_hex;
+	// JSON it decodes to; nullptr when it is refused
+	const char* json_text;
+};
+
+static const KnownRequest REQUESTS[] = {
+	// {"g_b": bin 01 23}
+	{"msgpack-bin", WireFormat::MSGPACK, "81a3675f62c4020123", "{\"g_b\":\"123\"}"},
+	// {"r_i": [bin 00 ff, "ab"]}, hex text is taken as well
+	{"msgpack-list", WireFormat::MSGPACK, "81a3725f6992c40200ffa26162", "{\"r_i\":[\"ff\",\"ab\"]}"},
+	// {"a": bin of no bytes}
+	{"msgpack-zero", WireFormat::MSGPACK, "81a161c400", "{\"a\":\"0\"}"},
+	// {"a": "\xff"}
+	{"msgpack-0xff", WireFormat::MSGPACK, "81a161a1ff", nullptr},
+	// {"g_b": h'0123'}
+	{"cbor-bytes", WireFormat::CBOR, "a163675f62420123", "{\"g_b\":\"123\"}"},
+	// {"g_b": 2(h'0123')}
+	{"cbor-bignum", WireFormat::CBOR, "a163675f62c2420123", "{\"g_b\":\"123\"}"},
+	// {"x": 3(h'ff')}, -1 - 255
+	{"cbor-negative", WireFormat::CBOR, "a16178c341ff", "{\"x\":\"-100\"}"},
+	// {"x": (_ h'01', h'23')}
+	{"cbor-chunked", WireFormat::CBOR, "a161785f41014123ff", "{\"x\":\"123\"}"},
+	// {"x": 3("A")}
+	{"cbor-negative-text", WireFormat::CBOR, "a16178c36141", nullptr},
+	// {"x": (_ "a", "\xff")}
+	{"cbor-chunked-0xff", WireFormat::CBOR, "a161787f616161ffff", nullptr}
+};
+
+struct KnownReply
+{
+	WireFormat format;
+	const char* bytes_hex;
+};
+
+// {"g_b": 123h, "neg": -100h, "req": "0101", "res": [ffh, 0]}, keys in
+// the order json.hpp keeps them
+static const KnownReply REPLIES[] = {
+	{WireFormat::JSON,
+		"7b22675f62223a22313233222c226e6567223a222d313030222c22726571223a2230313031222c22726573223a5b226666222c2230225d7d"},
+	{WireFormat::MSGPACK,
+		"84a3675f62c4020123a36e6567a42d313030a3726571a430313031a372657392c401ffc400"},
+	{WireFormat::CBOR,
+		"a463675f62420123636e6567c341ff637265716430313031637265738241ff40"}
+};
+
+static string bytes_of(const char* hex)
+{
+	return hex_to_bytes(string("01") + hex).substr(1);
+}
+
+static bool check_request(const KnownRequest& known)
+{
+	string bytes = bytes_of(known.bytes_hex);
+	try
+	{
+		json j = decode_request(known.format, bytes.data(), bytes.data() + bytes.size());
+		return known.json_text != nullptr && j == json::parse(known.json_text);
+	}
+	catch(std::exception&)
+	{
+		return known.json_text == nullptr;
+	}
+}
+
+static json reply()
+{
+	return {
+		{"g_b", wire_integer("123")},
+		{"neg", wire_integer("-100")},
+		{"req", "0101"},
+		{"res", wire_integers({"ff", "0"})}
+	};
+}
+
+static bool check_reply(const KnownReply& known)
+{
+	string bytes = encode_reply(known.format, reply());
+	json expected = {{"g_b", "123"}, {"neg", "-100"}, {"req", "0101"}, {"res", {"ff", "0"}}};
+
+	return bytes == bytes_of(known.bytes_hex)
+		&& decode_request(known.format, bytes.data(), bytes.data() + bytes.size()) == expected;
+}
+
+int main()
+{
+	int failed = 0;
+	for(const KnownRequest& known : REQUESTS)
+	{
+		bool ok = check_request(known);
+		cout << known.id << "\t" << (ok ? "ok" : "FAILED") << endl;
+		failed += !ok;
+	}
+	for(const KnownReply& known : REPLIES)
+	{
+		bool ok = check_reply(known);
+		cout << "reply-" << wire_format_name(known.format) << "\t" << (ok ? "ok" : "FAILED") << endl;
+		failed += !ok;
+	}
+
+	// Bytes that once passed for an integer in JSON are no hex
+	bool ok = false;
+	string text = "{\"g_b\":\"\\u0001\\u0023\"}";
+	try
+	{
+		integer_from_string(decode_request(WireFormat::JSON, text.data(), text.data() + text.size())["g_b"]);
+	}
+	catch(std::invalid_argument&)
+	{
+		ok = true;
+	}
+	cout << "json-raw-bytes\t" << (ok ? "ok" : "FAILED") << endl;
+	failed += !ok;
+
+	if(failed)
+	{
+		cerr << failed << " wire format known answers wrong" << endl;
+		return 1;
+	}
+	return 0;
+}
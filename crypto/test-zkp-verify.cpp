@@ -0,0 +1,226 @@
+// g++ -g -O2 -I. -I/usr/include/cryptopp test-zkp-verify.cpp -o test-zkp-verify.exe -lcryptopp -lpthread
+
+// Known answers of zkp_verify.h: ANSWER TXNs over named groups whose
+// commitments were computed independently with Python's pow. With
+// r = G / 11, g_ab = G / 13 and r_i = G / (17 + 2i):
+//
+//   g_r_i       g^{r_i} mod G
+//   g_g_ab_p_r  g^{g_ab} g^r, the product as the requester sends it
+//
+// and req 0110, so res_i is r_i or r_i + r + g_ab. The valid answers must
+// pass verify_answer, batch_verify and verify_answers; a response off by
+// one, a bad challenge char, a negated g_r_i (outside the subgroup, it
+// passes the batch equation for an even weight) and a mixed batch must be
+// caught, and only in the tryouts they touch. Exits with 1 on the first
+// wrong answer.
+//
+// Usage: test-zkp-verify.exe
+
+#include <iostream>
+using std::cout;
+using std::cerr;
+using std::endl;
+
+#include <stdexcept>
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include "cryptopp/integer.h"
+using CryptoPP::Integer;
+
+#include "named_groups.h"
+#include "thread_pool.h"
+#include "zkp_verify.h"
+
+static const size_t K = 4;
+
+struct KnownAnswer
+{
+	const char* id;
+	const char* g_r_i_hex[K];
+	const char* g_g_ab_p_r_hex;
+};
+
+static const KnownAnswer ANSWERS[] = {
+	{"modp1024",
+		{
+			"FFEAAE2843513639115104A10350DA2F6BBCEEE8192FCA74DE9EDC6BD7C3A858"
+			"71E7F0AC23BDDF6C233D80A4EAEE9858DAA2CC0F752F429C9B88913D445DDE6D"
+			"81D00F6AC5C93C357F115C2CDCE454204C724505CF954E45C28487D12D29D352"
+			"9DB23ACFBD9C750FB5508576BCFF95970D05EEFF17CCE62F42CBFA04062FECAB",
+			"1BB58CCDE3C42E712B47A7BB06EA7F468CBC667086D31FB285B25D4FF0A3E474"
+			"EED66A7B107A27EAFF2D69081F6F3D19089EC4FB0FE5E75C2373E5406BFEF331"
+			"9C0C87B275786474E908602933DFF387C23E8911BC5D919B4C2B3E0B15441CCC"
+			"760AC2B0AC177E16EE2DD14DA897CAFE7FA438EAE76C2D68AFA343CF66D481DA",
+			"B81D9EA8BCF640B861B06571551F5B009C51D8379F5F631EA1C131B61BC5D004"
+			"30AC785D292473547FF90CF1EBFADE1542D68956DA8C5315512D42B8657C6C71"
+			"8C74225197D260A7600E5F061FB85977869F67799208AE1B2D198AAF221A66A5"
+			"C97E448581C31D648C51136E2BD6005A25D02AECF9BE08C3773191A42EB0A087",
+			"59101E78834167633AFF4BB0CBDEF6CB2D7B6882064ADC26486E4AC14DD993A9"
+			"DE8F78D5C6BF1376CA16E4F605FDB6301A5B24D860CD3694B89B8D0A192CCA37"
+			"EB53B68E380BFE7A18A60019242024B678472AAFAD2E8CBE08DE89A396D28E1D"
+			"FEBD0677DB29F3BB60D51CE0ADA160F846992CEA0C7E4AB436D3B6306B046EDD"
+		},
+		"8589376CF613B10C9D50269BA0820A014E38F3E5B83D8ED53529ACD40955A73D"
+		"355AA31B05438E597828D9D5E08A723820EEF3D0205332A235C6E40DC4C7581B"
+		"B3490C787920D80839AF175580E4E11EA45FE33FBA42CF6250539307FEE42D78"
+		"46BEBF4238E564B92BE0B9336E355D3689C7A132959530EA8E6CBB4392833C3A"
+		"0CA08DC6FFE367D37BCAC92262D3F75E32EFD30EE4830DF2E173CEC0AB21B453"
+		"71203703A28D6FDFC6FC988FF7A614AC47C8AD55B6143D0140DB3643E2693EDD"
+		"E0E8F3FDD6D34728112E27BD3E354FF2EA3647AFD385C861F2C1ECDF7188AD78"
+		"F55C471A2ACFBFC46F1A16CA413B61BB8E6E4BDDD4DE285012B655751465732B"},
+	{"ffdhe2048",
+		{
+			"92DA81EE8334AD69B98BF61618C72AF439E2FC7583A35C5F487FDAE0CC1B822A"
+			"3D6552B9A00E275CF30C7E4B3653633E02CCC9FB6454886AFE0378F5507F7467"
+			"092AB243F3453444500FE9B697B59F0CC4FED407BBF7488DDFC7868354BFD173"
+			"AE3FDD3E99A6224A53271BEF30129D09D632AC3ADAA366C2672B0290CCB384C7"
+			"6A67AA7F1A0F59EC41AD82676354E399618A1A6F11D81D9AF3FC669E46FC2D4B"
+			"69C72AABF6C712A4760D7362A3B2AE95B8527CBE5B8785B7641BCBC7F5C51088"
+			"5EDCCF63C7A2175FAB41F3B3D282BE70C0D4DDA935F6D488FD896EEB22B7714A"
+			"3C6385B6637281BCB532F0D13589F67F65ACA67FAC173B0BFA704689303D8739",
+			"AD8DC954BC681AF46F2C4797FF9AEDA9F192F5FFF751B9191E741ED6DA270180"
+			"6EEBD5001DB01EA1C75C357CC385FDFD613ED46F74724E7AE70DB1EF73D43362"
+			"5043AD8A946D8C8E3EFB89D7ACC043F70362A898707C0732BD3842D8AD827DB1"
+			"E0A1741F7DB3AD46AC9F088A3BA17EFF3EB5E78314BBA60276A3A46251AD0C0C"
+			"33370FA04D0841304DCC7BEDEE32D0F886FA46061AF04119661B827A8CAAC8C0"
+			"BE8BDCCF5B1747F355A3E54435D50FD10930297759EFCC4021DB37C5AD3032ED"
+			"ECB025A14653341BBEEE7CBC14AF2BA51688CEFF96724AC250DEC196CE35C720"
+			"2BDCC4D9869B38879DDFFAFCC0354463F663A41D5C39244F648DEB4146A571EF",
+			"C927DDF4891ED6CA35699AF1D5F4F79E17FA117978D32C884CED644C47BDEE32"
+			"B6F450E8EB61E124ED95A77E2C9EF719C9B959B11AA80E9DEB007DE01F1D7428"
+			"B6FCA5029ACACC37AC9024DFB8F0581EA664F3CF44CCBE2A16577A29B2DBAB1B"
+			"8EF9AD6130D44C263815F65EF39F7CDE566AD8FA9C26A9B72122A15083D83B58"
+			"C7B3E73C42E69C403395E41089546A8528AD30A7DEA7C99D15324752DC2D04F3"
+			"D2F1A2B275D4B43FB58BA3DA9C2D9598B428082C51897BCB0697944459C9D5B7"
+			"8404776B414638970278945ED92FAC625EDC2AF4C2702E29418D7D911130337A"
+			"D807D3C7F22BC337624547300455B8707E2BA61CCA9B13E7BFA742FD39200A7B",
+			"55585719B6EA7AA56124C4CCABD3C52FFEB2F3364BE56DFE34A64F0B658ADAC1"
+			"AEE45D096BAD6E6952BF0DCBB977AE3216510684FFD186EF2FA4FC12331837F5"
+			"8A43D15658605FA0F7F181D0BC2C5165D54729294E467BED9CCA33AE8024DA7C"
+			"0640E08158F212E06CE69ABB1A6E71F1C3F489543156A59C2D891491112E89BF"
+			"5314D261DD74660ADC38ED806A6E13CA2513CAA564EFC4B8BA5F6F2811FF3401"
+			"7CF8FD6DE3F822888B6E3A4396B2B0BFDDB04DD673E7E56B1B73571476DF706C"
+			"AB90623F5FA53246769473DF488AD9723E277CABC7A5C7B71730ECED49E348E2"
+			"59745C2AA13FE99DD45BEF6A924E68AB2EE6E90C0C7E16A4C15966616A4A7CF0"
+		},
+		"8542251EBFBB2001FE7030E3C87B5CA66CE8EB0B73644FFF3CCB82A2076B44AD"
+		"675C8418B73C8B756F3E3462EB68E83302012E4CBCF4B9568C59D4DE9AE50276"
+		"CC9D39AD474AF955D6EBCB7113A0C0AE5816AC436243CEE29CC26BAD50A004EA"
+		"32D2D3CA38A08F138AE8FB94BFDF0F8BD83A919C8701C6FA70ADE93F36199685"
+		"430CA80264C5969214235D69999F2887318796ABF5CDF5FF5FAF96F430E82318"
+		"FFBABB4CC7E959267BCB29E1F81E4F4999F492B7CE3BF918F6E0608068633E22"
+		"04E9A4C2E3008B56D2554D3D64C2C938869E10450CB65D9A24A5DAB807E9DB89"
+		"867640ED8F23A46B76613F619EDD78F4E9AD50074D12D019F245FE55465EB82B"
+		"F549C7BECB52D37EB3B82ED769E4F5A2012C1158FDA325DF9BFC55DEB93CE911"
+		"963A9E188305131EC288D4623AEEDFB1A25376B1F1466798711EA221A5A6A3AC"
+		"3D2F675A146174357BED6F1F1E7817B3CA4DA1C0B62BED12FE03896A963C8DF8"
+		"C20BEEA3080B7A60B65FB014200D51420D91253DF5D61ECC7CCEFEFC70E55066"
+		"40B1AE74496E59C666291F88C3DC9FD556C83FFCD38370BD34B3AAB4C6025986"
+		"A0190F308AF9F91FE5441B88BB77B3F348FAA72AFDF22B15184CF805A9C5C82A"
+		"27C7F1417C024D843670B0771E895FFB01A6EBDBB1B3A06992AF8854BB9EDDD8"
+		"79638DBA8B5A64BB23CAAB3A6F947EA1026636AF6688927A4CCF75D6031E0A78"}
+};
+
+static Integer from_hex(const char* hex)
+{
+	return Integer((string(hex) + "h").c_str());
+}
+
+static ZkpAnswer answer_of(const KnownAnswer& known)
+{
+	const NamedGroup& named = *find_named_group(known.id);
+
+	ZkpAnswer answer;
+	answer.G = named_group(named).p;
+	answer.g = Integer((long)named.g);
+	answer.g_g_ab_p_r = from_hex(known.g_g_ab_p_r_hex);
+	answer.req = "0110";
+
+	const Integer r = answer.G / 11;
+	const Integer g_ab = answer.G / 13;
+	for(size_t i = 0; i < K; i++)
+	{
+		const Integer r_i = answer.G / Integer((long)(17 + 2 * i));
+		answer.g_r_i.push_back(from_hex(known.g_r_i_hex[i]));
+		answer.res.push_back(answer.req[i] == '1' ? r_i + r + g_ab : r_i);
+	}
+	return answer;
+}
+
+static bool check(const KnownAnswer& known)
+{
+	const ZkpAnswer valid = answer_of(known);
+
+	ZkpAnswer wrong_one = valid;
+	wrong_one.res[2] += Integer::One();
+
+	ZkpAnswer wrong_zero = valid;
+	wrong_zero.res[0] += Integer::One();
+
+	ZkpAnswer bad_req = valid;
+	bad_req.req[3] = 'x';
+
+	// -1 is no quadratic residue, for G = 3 mod 4
+	ZkpAnswer outside = valid;
+	outside.g_r_i[1] = valid.G - valid.g_r_i[1];
+
+	ZkpAnswer short_res = valid;
+	short_res.res.pop_back();
+
+	bool malformed = false;
+	try
+	{
+		verify_answer(short_res);
+	}
+	catch(std::invalid_argument&)
+	{
+		malformed = true;
+	}
+
+	vector<vector<size_t>> failed = verify_answers({valid, wrong_one, valid, outside});
+
+	// Over fresh weights, as the subgroup check has to hold for any
+	bool outside_refused = true;
+	for(int n = 0; n < 16; n++)
+		outside_refused = outside_refused && !batch_verify({&outside}, thread_rng());
+
+	return verify_answer(valid).empty()
+		&& verify_answer(wrong_one) == vector<size_t>{2}
+		&& verify_answer(wrong_zero) == vector<size_t>{0}
+		&& verify_answer(bad_req) == vector<size_t>{3}
+		&& verify_answer(outside) == vector<size_t>{1}
+		&& malformed
+		&& batch_verify({&valid, &valid}, thread_rng())
+		&& !batch_verify({&valid, &wrong_one}, thread_rng())
+		&& !batch_verify({&wrong_zero}, thread_rng())
+		&& outside_refused
+		&& failed == vector<vector<size_t>>{{}, {2}, {}, {1}};
+}
+
+int main()
+{
+	int failed = 0;
+	for(const KnownAnswer& known : ANSWERS)
+	{
+		bool ok = check(known);
+		cout << known.id << "\t" << (ok ? "ok" : "FAILED") << endl;
+		failed += !ok;
+	}
+
+	// Answers of different groups are batched apart
+	bool ok = verify_answers({answer_of(ANSWERS[0]), answer_of(ANSWERS[1])}) == vector<vector<size_t>>{{}, {}};
+	cout << "groups\t" << (ok ? "ok" : "FAILED") << endl;
+	failed += !ok;
+
+	if(failed)
+	{
+		cerr << failed << " ZKP verification known answers wrong" << endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,159 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "cryptopp/osrng.h"
+
+// RNG of the calling thread. AutoSeededRandomPool is not thread safe, so
+// every worker gets its own instead of sharing one behind a lock.
+inline CryptoPP::AutoSeededRandomPool &thread_rng()
+{
+  static thread_local CryptoPP::AutoSeededRandomPool rnd;
+  return rnd;
+}
+
+// Fixed set of worker threads for CPU bound work of a single request
+// (e.g. the K tryouts of a DATA TXN, or a batch of RSA encryptions).
+class ThreadPool
+{
+  std::vector<std::thread> workers;
+  std::deque<std::function<void()>> jobs;
+
+  std::mutex m;
+  std::condition_variable has_job;
+  bool stopping = false;
+
+  void work_loop()
+  {
+    while (true) {
+      std::function<void()> job;
+      {
+        std::unique_lock<std::mutex> lock(m);
+        has_job.wait(lock, [&] { return stopping || !jobs.empty(); });
+        if (jobs.empty()) {
+          return;
+        }
+        job = std::move(jobs.front());
+        jobs.pop_front();
+      }
+      job();
+    }
+  }
+
+  // State of one parallel_for. Helpers that are scheduled after the loop
+  // has finished still find it alive, see that there is nothing left and
+  // return without touching the (gone) caller.
+  struct Loop
+  {
+    size_t n;
+    const std::function<void(size_t)> *fn;
+    std::atomic<size_t> next;
+
+    std::mutex m;
+    std::condition_variable finished;
+    size_t done = 0;
+    std::exception_ptr error;
+
+    Loop(size_t n, const std::function<void(size_t)> *fn) : n(n), fn(fn), next(0) {}
+
+    void run()
+    {
+      size_t i;
+      while ((i = next.fetch_add(1)) < n) {
+        std::exception_ptr e;
+        try {
+          (*fn)(i);
+        }
+        catch (...) {
+          e = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> lock(m);
+        if (e && !error) {
+          error = e;
+        }
+        if (++done == n) {
+          finished.notify_all();
+        }
+      }
+    }
+  };
+
+  public:
+  explicit ThreadPool(unsigned int num_threads)
+  {
+    for (unsigned int i = 0; i < num_threads; i++) {
+      workers.emplace_back(&ThreadPool::work_loop, this);
+    }
+  }
+
+  ~ThreadPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m);
+      stopping = true;
+    }
+    has_job.notify_all();
+
+    for (auto &worker : workers) {
+      worker.join();
+    }
+  }
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  size_t size() const { return workers.size(); }
+
+  void submit(std::function<void()> job)
+  {
+    {
+      std::lock_guard<std::mutex> lock(m);
+      jobs.push_back(std::move(job));
+    }
+    has_job.notify_one();
+  }
+
+  // Runs fn(0) ... fn(n - 1) on the workers and the calling thread, and
+  // returns once all of them are done. The first exception thrown by fn
+  // is rethrown here. Safe to call from a worker of the same pool.
+  void parallel_for(size_t n, const std::function<void(size_t)> &fn)
+  {
+    if (n == 0) {
+      return;
+    }
+
+    std::shared_ptr<Loop> loop = std::make_shared<Loop>(n, &fn);
+
+    size_t helpers = std::min(n - 1, workers.size());
+    for (size_t i = 0; i < helpers; i++) {
+      submit([loop] { loop->run(); });
+    }
+    loop->run();
+
+    std::unique_lock<std::mutex> lock(loop->m);
+    loop->finished.wait(lock, [&] { return loop->done == n; });
+    if (loop->error) {
+      std::rethrow_exception(loop->error);
+    }
+  }
+
+  // Pool shared by the whole calculator, one worker per core.
+  static ThreadPool &shared()
+  {
+    static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    return pool;
+  }
+};
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef TXN_PROFILE_H
+#define TXN_PROFILE_H
+
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+#include "json.hpp"
+
+// Security profile of a DATA TXN request (type 0).
+//
+//   {K : 20, dh_key_size : 1024, rsa_key_size : 2048, with_key : 0}
+//
+// or with a named group (see named_groups.h) instead of dh_key_size.
+// Fields that are missing keep the values main used to hardcode.
+struct TxnProfile
+{
+  unsigned int dh_key_size = 1024;
+  unsigned int rsa_key_size = 2048;
+  int K = 10;
+  bool with_key = false;
+  std::string group_id;
+
+  static unsigned int field(const nlohmann::json &request, const char *name,
+      unsigned int def, unsigned int min, unsigned int max, unsigned int multiple_of)
+  {
+    if (!request.count(name)) {
+      return def;
+    }
+
+    int value = request[name];
+    if (value < (int)min || value > (int)max || value % multiple_of != 0) {
+      throw std::invalid_argument(std::string("invalid ") + name);
+    }
+    return value;
+  }
+
+  static TxnProfile from_request(const nlohmann::json &request)
+  {
+    TxnProfile profile;
+    profile.dh_key_size = field(request, "dh_key_size", 1024, 512, 4096, 64);
+    profile.rsa_key_size = field(request, "rsa_key_size", 2048, 1024, 4096, 256);
+    profile.K = field(request, "K", 10, 1, 4096, 1);
+    profile.with_key = request.count("with_key") && request["with_key"] == 1;
+
+    if (request.count("group")) {
+      profile.group_id = request["group"].get<std::string>();
+    }
+    return profile;
+  }
+
+  // e.g. "dh=1024 rsa=2048 K=20", or "group=ffdhe2048 K=20" (no RSA key)
+  std::string name() const
+  {
+    std::string s;
+    if (group_id.empty()) {
+      s = "dh=" + std::to_string(dh_key_size);
+    }
+    else {
+      s = "group=" + group_id;
+    }
+
+    if (with_key) {
+      s += " rsa=" + std::to_string(rsa_key_size);
+    }
+    return s + " K=" + std::to_string(K);
+  }
+};
+
+// How often each profile was requested.
+class ProfileMetrics
+{
+  std::mutex m;
+  std::map<std::string, uint64_t> counts;
+
+  public:
+  void record(const TxnProfile &profile)
+  {
+    std::lock_guard<std::mutex> lock(m);
+    counts[profile.name()]++;
+  }
+
+  nlohmann::json status()
+  {
+    std::lock_guard<std::mutex> lock(m);
+
+    nlohmann::json result = nlohmann::json::object();
+    for (auto &kv : counts) {
+      result[kv.first] = kv.second;
+    }
+    return result;
+  }
+};
+
+#endif
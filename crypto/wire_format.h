@@ -0,0 +1,751 @@
+#ifndef WIRE_FORMAT_H
+#define WIRE_FORMAT_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "cryptopp/integer.h"
+
+#include "json.hpp"
+
+// Encodings of a request and its reply on the ZMQ link:
+//
+//   JSON     text, big integers as lower case hex (the original format)
+//   MSGPACK  MessagePack, big integers as bin of their big endian bytes
+//   CBOR     CBOR, big integers as byte strings (major type 2) of the same
+//
+// The format of a request is told by its first byte (a map starts with
+// 0x80-0x8f, 0xde or 0xdf in MessagePack and 0xa0-0xbf in CBOR, JSON with
+// '{' or white space), and the reply goes back in the same one; a client
+// learns which formats the calculator speaks from "wire_formats" of the
+// status reply.
+//
+// The json.hpp of the calculator (2.1.1) has no binary type, so the two
+// binary formats are read and written here, and what is an integer is
+// told by the wire type alone, never by a name or by the look of a value:
+//
+//   - In a request, a bin / byte string is an integer and the txns get
+//     its hex, the same string a JSON request has. A big integer may also
+//     be sent as hex text in either binary format.
+//   - In a reply, the txns mark every integer with wire_integer. Marked
+//     values go out as hex in JSON and as bin / byte strings otherwise,
+//     every other string as text. A negative integer is a CBOR negative
+//     bignum (tag 3); MessagePack has no type for it, so there it is its
+//     hex text, '-' first.
+
+enum class WireFormat { JSON, MSGPACK, CBOR };
+
+// First char of a reply value that wire_integer marks, its hex follows.
+// 0xff never occurs in UTF-8: the JSON parser refuses it and so does
+// decode_request in MessagePack / CBOR text, so no request can carry it.
+const char INTEGER_MARK = '\xff';
+
+// Hex of an integer of a reply (as integer_to_string writes it), marked so
+// that encode_reply sends it as an integer
+inline std::string wire_integer(const std::string &hex)
+{
+  return INTEGER_MARK + hex;
+}
+
+inline nlohmann::json wire_integers(const std::vector<std::string> &hex)
+{
+  nlohmann::json j = nlohmann::json::array();
+  for (auto &x : hex) {
+    j.push_back(wire_integer(x));
+  }
+  return j;
+}
+
+namespace wire_format_detail
+{
+  inline int hex_digit(char c)
+  {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+  }
+}
+
+// Big endian bytes of a hex number, without leading zero bytes
+inline std::string hex_to_bytes(const std::string &hex)
+{
+  std::string bytes((hex.size() + 1) / 2, '\0');
+  size_t k = bytes.size() * 2 - hex.size();
+  for (char c : hex) {
+    int d = wire_format_detail::hex_digit(c);
+    if (d < 0) {
+      throw std::invalid_argument("integer is not hex");
+    }
+    bytes[k / 2] |= (char)(k % 2 ? d : d << 4);
+    k++;
+  }
+
+  size_t zeros = 0;
+  while (zeros < bytes.size() && bytes[zeros] == '\0') {
+    zeros++;
+  }
+  return bytes.substr(zeros);
+}
+
+// Lower case hex without leading zeros ("0" for none), as the txns write it
+inline std::string bytes_to_hex(const std::string &bytes)
+{
+  static const char DIGITS[] = "0123456789abcdef";
+
+  std::string hex;
+  hex.reserve(2 * bytes.size());
+  for (unsigned char b : bytes) {
+    if (hex.empty() && b == 0) {
+      continue;
+    }
+    if (hex.empty() && b < 0x10) {
+      hex.push_back(DIGITS[b]);
+      continue;
+    }
+    hex.push_back(DIGITS[b >> 4]);
+    hex.push_back(DIGITS[b & 0xf]);
+  }
+  return hex.empty() ? "0" : hex;
+}
+
+// Integer to string (in hex format!) and back, the way the txns carry
+// their numbers. The hex comes from the encoding of the Integer rather
+// than an ostream.
+inline std::string integer_to_string(const CryptoPP::Integer &x)
+{
+  if (x.IsNegative()) {
+    return "-" + integer_to_string(-x);
+  }
+
+  std::string bytes(x.MinEncodedSize(), '\0');
+  x.Encode((CryptoPP::byte *)&bytes[0], bytes.size());
+  return bytes_to_hex(bytes);
+}
+
+inline CryptoPP::Integer integer_from_string(const std::string &s)
+{
+  CryptoPP::Integer x;
+  bool negative = !s.empty() && s[0] == '-';
+  std::string bytes = hex_to_bytes(negative ? s.substr(1) : s);
+
+  x.Decode((const CryptoPP::byte *)bytes.data(), bytes.size());
+  return negative ? -x : x;
+}
+
+namespace wire_format_detail
+{
+  inline bool is_marked(const std::string &s)
+  {
+    return !s.empty() && s[0] == INTEGER_MARK;
+  }
+
+  // Drops the marks of wire_integer, leaving the hex that JSON carries
+  inline void unmark(nlohmann::json &j)
+  {
+    if (j.is_string()) {
+      std::string &s = j.get_ref<std::string &>();
+      if (is_marked(s)) {
+        s.erase(0, 1);
+      }
+    }
+    else if (j.is_array() || j.is_object()) {
+      for (auto &item : j) {
+        unmark(item);
+      }
+    }
+  }
+
+  // Deeper nesting is refused rather than recursed into
+  const unsigned int MAX_DEPTH = 64;
+
+  // Reads one MessagePack or CBOR item into a json. Byte strings are
+  // integers and become their hex; text with 0xff (see INTEGER_MARK),
+  // extension types and CBOR simple values other than false, true, null
+  // and undefined are refused.
+  class Decoder
+  {
+    const uint8_t *p;
+    const uint8_t *end;
+    const char *format;
+
+    [[noreturn]] void fail(const char *what) const
+    {
+      throw std::invalid_argument(std::string(format) + ": " + what);
+    }
+
+    const uint8_t *take(uint64_t n)
+    {
+      if (n > (uint64_t)(end - p)) {
+        fail("unexpected end of input");
+      }
+      const uint8_t *q = p;
+      p += n;
+      return q;
+    }
+
+    uint64_t big_endian(unsigned int n)
+    {
+      const uint8_t *q = take(n);
+      uint64_t x = 0;
+      for (unsigned int i = 0; i < n; i++) {
+        x = (x << 8) | q[i];
+      }
+      return x;
+    }
+
+    double float_of(unsigned int n)
+    {
+      uint64_t bits = big_endian(n);
+      if (n == 4) {
+        uint32_t b = (uint32_t)bits;
+        float f;
+        std::memcpy(&f, &b, sizeof(f));
+        return f;
+      }
+      double d;
+      std::memcpy(&d, &bits, sizeof(d));
+      return d;
+    }
+
+    std::string string_of(uint64_t n, bool bytes)
+    {
+      const char *q = (const char *)take(n);
+      if (bytes) {
+        return bytes_to_hex(std::string(q, n));
+      }
+      if (std::memchr(q, 0xff, n) != nullptr) {
+        fail("text is not UTF-8");
+      }
+      return std::string(q, n);
+    }
+
+    void check_depth(unsigned int depth) const
+    {
+      if (depth > MAX_DEPTH) {
+        fail("nested too deep");
+      }
+    }
+
+    nlohmann::json msgpack_array(uint64_t n, unsigned int depth)
+    {
+      nlohmann::json j = nlohmann::json::array();
+      for (uint64_t i = 0; i < n; i++) {
+        j.push_back(msgpack(depth + 1));
+      }
+      return j;
+    }
+
+    nlohmann::json msgpack_map(uint64_t n, unsigned int depth)
+    {
+      nlohmann::json j = nlohmann::json::object();
+      for (uint64_t i = 0; i < n; i++) {
+        nlohmann::json key = msgpack(depth + 1);
+        if (!key.is_string()) {
+          fail("map key is not a string");
+        }
+        j[key.get<std::string>()] = msgpack(depth + 1);
+      }
+      return j;
+    }
+
+    uint64_t cbor_argument(uint8_t info)
+    {
+      if (info < 24) {
+        return info;
+      }
+      if (info <= 27) {
+        return big_endian(1 << (info - 24));
+      }
+      fail("malformed length");
+    }
+
+    // End of an item of indefinite length
+    bool cbor_break()
+    {
+      if (p < end && *p == 0xff) {
+        p++;
+        return true;
+      }
+      return false;
+    }
+
+    public:
+    Decoder(const char *begin, const char *end, const char *format)
+      : p((const uint8_t *)begin), end((const uint8_t *)end), format(format) {}
+
+    bool done() const { return p == end; }
+
+    nlohmann::json msgpack(unsigned int depth = 0)
+    {
+      check_depth(depth);
+
+      uint8_t b = *take(1);
+      if (b <= 0x7f) {
+        return (uint64_t)b;
+      }
+      if (b >= 0xe0) {
+        return (int64_t)(int8_t)b;
+      }
+      if (b <= 0x8f) {
+        return msgpack_map(b & 0x0f, depth);
+      }
+      if (b <= 0x9f) {
+        return msgpack_array(b & 0x0f, depth);
+      }
+      if (b <= 0xbf) {
+        return string_of(b & 0x1f, false);
+      }
+
+      switch (b) {
+        case 0xc0: return nullptr;
+        case 0xc2: return false;
+        case 0xc3: return true;
+        case 0xc4: case 0xc5: case 0xc6: return string_of(big_endian(1 << (b - 0xc4)), true);
+        case 0xca: return float_of(4);
+        case 0xcb: return float_of(8);
+        case 0xcc: case 0xcd: case 0xce: case 0xcf: return big_endian(1 << (b - 0xcc));
+        case 0xd0: case 0xd1: case 0xd2: case 0xd3: {
+          unsigned int n = 1 << (b - 0xd0);
+          uint64_t x = big_endian(n);
+          if (n < 8 && (x >> (8 * n - 1))) {
+            x |= ~0ULL << (8 * n);
+          }
+          return (int64_t)x;
+        }
+        case 0xd9: case 0xda: case 0xdb: return string_of(big_endian(1 << (b - 0xd9)), false);
+        case 0xdc: return msgpack_array(big_endian(2), depth);
+        case 0xdd: return msgpack_array(big_endian(4), depth);
+        case 0xde: return msgpack_map(big_endian(2), depth);
+        case 0xdf: return msgpack_map(big_endian(4), depth);
+      }
+      fail("unsupported type");
+    }
+
+    nlohmann::json cbor(unsigned int depth = 0)
+    {
+      check_depth(depth);
+
+      uint8_t b = *take(1);
+      uint8_t major = b >> 5;
+      uint8_t info = b & 0x1f;
+      bool indefinite = info == 31 && major >= 2 && major <= 5;
+
+      switch (major) {
+        case 0:
+          return cbor_argument(info);
+
+        case 1: {
+          uint64_t n = cbor_argument(info);
+          if (n > (uint64_t)std::numeric_limits<int64_t>::max()) {
+            fail("integer out of range");
+          }
+          return -1 - (int64_t)n;
+        }
+
+        case 2: case 3: {
+          if (!indefinite) {
+            return string_of(cbor_argument(info), major == 2);
+          }
+          // Chunks of definite length and the same type
+          std::string s;
+          while (!cbor_break()) {
+            uint8_t c = *take(1);
+            if (c >> 5 != major || (c & 0x1f) == 31) {
+              fail("malformed chunk");
+            }
+            s += string_of(cbor_argument(c & 0x1f), false);
+          }
+          return major == 2 ? bytes_to_hex(s) : s;
+        }
+
+        case 4: {
+          nlohmann::json j = nlohmann::json::array();
+          uint64_t n = indefinite ? 0 : cbor_argument(info);
+          for (uint64_t i = 0; indefinite ? !cbor_break() : i < n; i++) {
+            j.push_back(cbor(depth + 1));
+          }
+          return j;
+        }
+
+        case 5: {
+          nlohmann::json j = nlohmann::json::object();
+          uint64_t n = indefinite ? 0 : cbor_argument(info);
+          for (uint64_t i = 0; indefinite ? !cbor_break() : i < n; i++) {
+            nlohmann::json key = cbor(depth + 1);
+            if (!key.is_string()) {
+              fail("map key is not a string");
+            }
+            j[key.get<std::string>()] = cbor(depth + 1);
+          }
+          return j;
+        }
+
+        // Tags, e.g. 2 (unsigned bignum) around a byte string, are
+        // skipped, except 3: a negative bignum, -1 - n for the bytes n
+        case 6: {
+          if (cbor_argument(info) != 3) {
+            return cbor(depth + 1);
+          }
+          if (p == end || *p >> 5 != 2) {
+            fail("negative bignum is not a byte string");
+          }
+          CryptoPP::Integer n = integer_from_string(cbor(depth + 1).get<std::string>());
+          return integer_to_string(-(n + CryptoPP::Integer::One()));
+        }
+      }
+
+      switch (info) {
+        case 20: return false;
+        case 21: return true;
+        case 22: case 23: return nullptr;
+        case 25: {
+          uint16_t h = (uint16_t)big_endian(2);
+          int exponent = (h >> 10) & 0x1f;
+          int mantissa = h & 0x3ff;
+          double v = exponent == 0 ? std::ldexp(mantissa, -24) :
+            exponent != 31 ? std::ldexp(mantissa + 1024, exponent - 25) :
+            mantissa == 0 ? std::numeric_limits<double>::infinity() :
+            std::numeric_limits<double>::quiet_NaN();
+          return h & 0x8000 ? -v : v;
+        }
+        case 26: return float_of(4);
+        case 27: return float_of(8);
+      }
+      fail("unsupported simple value");
+    }
+  };
+
+  // Writes a json as MessagePack or CBOR, in the smallest form of every
+  // number and length. Strings marked by wire_integer go out as integers,
+  // any other string as text.
+  class Encoder
+  {
+    std::string out;
+
+    void put(uint8_t b) { out.push_back((char)b); }
+
+    void big_endian(uint64_t x, unsigned int n)
+    {
+      for (unsigned int i = n; i-- > 0;) {
+        put((uint8_t)(x >> (8 * i)));
+      }
+    }
+
+    void float_bits(double d)
+    {
+      uint64_t bits;
+      std::memcpy(&bits, &d, sizeof(bits));
+      big_endian(bits, 8);
+    }
+
+    // Length n after the first of op8, op16, op32 that takes it; op8 is
+    // 0 for the types without an 8-bit length
+    void msgpack_length(uint64_t n, uint8_t op8, uint8_t op16, uint8_t op32)
+    {
+      if (op8 != 0 && n <= 0xff) {
+        put(op8);
+        big_endian(n, 1);
+      }
+      else if (n <= 0xffff) {
+        put(op16);
+        big_endian(n, 2);
+      }
+      else {
+        put(op32);
+        big_endian(n, 4);
+      }
+    }
+
+    void msgpack_unsigned(uint64_t x)
+    {
+      if (x <= 0x7f) {
+        put((uint8_t)x);
+      }
+      else if (x <= 0xff) {
+        put(0xcc);
+        big_endian(x, 1);
+      }
+      else if (x <= 0xffff) {
+        put(0xcd);
+        big_endian(x, 2);
+      }
+      else if (x <= 0xffffffff) {
+        put(0xce);
+        big_endian(x, 4);
+      }
+      else {
+        put(0xcf);
+        big_endian(x, 8);
+      }
+    }
+
+    void msgpack_signed(int64_t x)
+    {
+      if (x >= 0) {
+        msgpack_unsigned(x);
+      }
+      else if (x >= -32) {
+        put((uint8_t)x);
+      }
+      else if (x >= std::numeric_limits<int8_t>::min()) {
+        put(0xd0);
+        big_endian(x, 1);
+      }
+      else if (x >= std::numeric_limits<int16_t>::min()) {
+        put(0xd1);
+        big_endian(x, 2);
+      }
+      else if (x >= std::numeric_limits<int32_t>::min()) {
+        put(0xd2);
+        big_endian(x, 4);
+      }
+      else {
+        put(0xd3);
+        big_endian(x, 8);
+      }
+    }
+
+    void msgpack_text(const std::string &s)
+    {
+      if (s.size() < 32) {
+        put(0xa0 | s.size());
+      }
+      else {
+        msgpack_length(s.size(), 0xd9, 0xda, 0xdb);
+      }
+      out += s;
+    }
+
+    void cbor_head(uint8_t major, uint64_t n)
+    {
+      major <<= 5;
+      if (n < 24) {
+        put(major | n);
+      }
+      else if (n <= 0xff) {
+        put(major | 24);
+        big_endian(n, 1);
+      }
+      else if (n <= 0xffff) {
+        put(major | 25);
+        big_endian(n, 2);
+      }
+      else if (n <= 0xffffffff) {
+        put(major | 26);
+        big_endian(n, 4);
+      }
+      else {
+        put(major | 27);
+        big_endian(n, 8);
+      }
+    }
+
+    public:
+    const std::string &bytes() const { return out; }
+
+    void msgpack(const nlohmann::json &j)
+    {
+      switch (j.type()) {
+        case nlohmann::json::value_t::boolean:
+          put(j.get<bool>() ? 0xc3 : 0xc2);
+          break;
+
+        case nlohmann::json::value_t::number_unsigned:
+          msgpack_unsigned(j.get<uint64_t>());
+          break;
+
+        case nlohmann::json::value_t::number_integer:
+          msgpack_signed(j.get<int64_t>());
+          break;
+
+        case nlohmann::json::value_t::number_float:
+          put(0xcb);
+          float_bits(j.get<double>());
+          break;
+
+        case nlohmann::json::value_t::string: {
+          const std::string &s = j.get_ref<const std::string &>();
+          if (!is_marked(s)) {
+            msgpack_text(s);
+          }
+          else if (s[1] == '-') {
+            msgpack_text(s.substr(1));
+          }
+          else {
+            std::string bytes = hex_to_bytes(s.substr(1));
+            msgpack_length(bytes.size(), 0xc4, 0xc5, 0xc6);
+            out += bytes;
+          }
+          break;
+        }
+
+        case nlohmann::json::value_t::array:
+          if (j.size() < 16) {
+            put(0x90 | j.size());
+          }
+          else {
+            msgpack_length(j.size(), 0, 0xdc, 0xdd);
+          }
+          for (auto &item : j) {
+            msgpack(item);
+          }
+          break;
+
+        case nlohmann::json::value_t::object:
+          if (j.size() < 16) {
+            put(0x80 | j.size());
+          }
+          else {
+            msgpack_length(j.size(), 0, 0xde, 0xdf);
+          }
+          for (auto it = j.begin(); it != j.end(); ++it) {
+            msgpack_text(it.key());
+            msgpack(it.value());
+          }
+          break;
+
+        default:
+          put(0xc0);
+      }
+    }
+
+    void cbor(const nlohmann::json &j)
+    {
+      switch (j.type()) {
+        case nlohmann::json::value_t::boolean:
+          put(j.get<bool>() ? 0xf5 : 0xf4);
+          break;
+
+        case nlohmann::json::value_t::number_unsigned:
+          cbor_head(0, j.get<uint64_t>());
+          break;
+
+        case nlohmann::json::value_t::number_integer: {
+          int64_t x = j.get<int64_t>();
+          if (x >= 0) {
+            cbor_head(0, x);
+          }
+          else {
+            cbor_head(1, (uint64_t)(-(x + 1)));
+          }
+          break;
+        }
+
+        case nlohmann::json::value_t::number_float:
+          put(0xfb);
+          float_bits(j.get<double>());
+          break;
+
+        case nlohmann::json::value_t::string: {
+          const std::string &s = j.get_ref<const std::string &>();
+          if (!is_marked(s)) {
+            cbor_head(3, s.size());
+            out += s;
+            break;
+          }
+
+          std::string hex = s.substr(1);
+          if (hex[0] == '-') {
+            // -1 - n, n = |x| - 1
+            hex = integer_to_string(-integer_from_string(hex) - CryptoPP::Integer::One());
+            put(0xc3);
+          }
+          std::string bytes = hex_to_bytes(hex);
+          cbor_head(2, bytes.size());
+          out += bytes;
+          break;
+        }
+
+        case nlohmann::json::value_t::array:
+          cbor_head(4, j.size());
+          for (auto &item : j) {
+            cbor(item);
+          }
+          break;
+
+        case nlohmann::json::value_t::object:
+          cbor_head(5, j.size());
+          for (auto it = j.begin(); it != j.end(); ++it) {
+            cbor_head(3, it.key().size());
+            out += it.key();
+            cbor(it.value());
+          }
+          break;
+
+        default:
+          put(0xf6);
+      }
+    }
+  };
+}
+
+inline WireFormat wire_format_of(const char *begin, const char *end)
+{
+  if (begin == end) {
+    return WireFormat::JSON;
+  }
+
+  unsigned char first = *begin;
+  if ((first >= 0x80 && first <= 0x8f) || first == 0xde || first == 0xdf) {
+    return WireFormat::MSGPACK;
+  }
+  if (first >= 0xa0 && first <= 0xbf) {
+    return WireFormat::CBOR;
+  }
+  return WireFormat::JSON;
+}
+
+inline const char *wire_format_name(WireFormat format)
+{
+  switch (format) {
+    case WireFormat::MSGPACK: return "msgpack";
+    case WireFormat::CBOR: return "cbor";
+    default: return "json";
+  }
+}
+
+// Request in the given format; integers that came as bytes are their hex
+inline nlohmann::json decode_request(WireFormat format, const char *begin, const char *end)
+{
+  if (format == WireFormat::JSON) {
+    return nlohmann::json::parse(begin, end);
+  }
+
+  wire_format_detail::Decoder decoder(begin, end, wire_format_name(format));
+  nlohmann::json j = format == WireFormat::MSGPACK ? decoder.msgpack() : decoder.cbor();
+  if (!decoder.done()) {
+    throw std::invalid_argument(std::string(wire_format_name(format)) + ": trailing bytes");
+  }
+  return j;
+}
+
+// Reply in the given format, see wire_integer; a null reply is sent as
+// an empty frame
+inline std::string encode_reply(WireFormat format, const nlohmann::json &reply)
+{
+  if (reply.is_null()) {
+    return "";
+  }
+  if (format == WireFormat::JSON) {
+    nlohmann::json text = reply;
+    wire_format_detail::unmark(text);
+    return text.dump();
+  }
+
+  wire_format_detail::Encoder encoder;
+  if (format == WireFormat::MSGPACK) {
+    encoder.msgpack(reply);
+  }
+  else {
+    encoder.cbor(reply);
+  }
+  return encoder.bytes();
+}
+
+#endif
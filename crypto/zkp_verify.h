@@ -0,0 +1,263 @@
+#ifndef ZKP_VERIFY_H
+#define ZKP_VERIFY_H
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "cryptopp/cryptlib.h"
+#include "cryptopp/integer.h"
+#include "cryptopp/nbtheory.h"
+
+#include "fixed_base.h"
+#include "montgomery.h"
+#include "thread_pool.h"
+
+// Everything needed to check an ANSWER TXN: the commitments of its DATA
+// TXN, the challenge of its REQUEST TXN and the responses.
+struct ZkpAnswer
+{
+  CryptoPP::Integer G;
+  CryptoPP::Integer g;
+
+  // g^{r_i} of the data txn
+  std::vector<CryptoPP::Integer> g_r_i;
+
+  // g^{g_ab} * (secret - H(identity)) of the request txn
+  CryptoPP::Integer g_g_ab_p_r;
+
+  // Challenge bits, '0' or '1' per tryout
+  std::string req;
+
+  // r_i for a '0', r_i + r + g_ab for a '1'
+  std::vector<CryptoPP::Integer> res;
+};
+
+// Checks every tryout of an answer:
+//
+//   g^{res_i} == g^{r_i}                     for a '0'
+//   g^{res_i} == g^{r_i} * g_g_ab_p_r mod G  for a '1'
+//
+// where g_g_ab_p_r = g^{g_ab} g^r when the requester used the identity of
+// the data txn. Only g is raised to a secret dependent power, so each
+// check is one exponentiation with the fixed-base table of the group and
+// at most one multiplication; the tryouts are spread over pool.
+//
+// Returns the indices of the tryouts that failed, empty when the answer
+// is valid. Throws std::invalid_argument when the answer is malformed.
+inline std::vector<size_t> verify_answer(const ZkpAnswer &answer,
+    ThreadPool &pool = ThreadPool::shared())
+{
+  const size_t K = answer.req.size();
+  if (answer.g_r_i.size() != K || answer.res.size() != K) {
+    throw std::invalid_argument("answer does not match the request");
+  }
+
+  auto base = FixedBaseCache::shared().table(answer.G, answer.g);
+  auto mont = MontgomeryCache::shared().context(answer.G);
+
+  CryptoPP::Integer y = answer.g_g_ab_p_r % answer.G;
+
+  std::vector<char> failed(K, 0);
+  pool.parallel_for(K, [&](size_t i) {
+    const CryptoPP::Integer &g_r_i = answer.g_r_i[i];
+    if (g_r_i <= CryptoPP::Integer::Zero() || g_r_i >= answer.G || answer.res[i].IsNegative()) {
+      failed[i] = 1;
+      return;
+    }
+
+    CryptoPP::Integer expected;
+    if (answer.req[i] == '0') {
+      expected = g_r_i;
+    }
+    else if (answer.req[i] == '1') {
+      expected = mont->multiply(g_r_i, y);
+    }
+    else {
+      failed[i] = 1;
+      return;
+    }
+
+    failed[i] = base->exponentiate(answer.res[i]) != expected;
+  });
+
+  std::vector<size_t> result;
+  for (size_t i = 0; i < K; i++) {
+    if (failed[i]) {
+      result.push_back(i);
+    }
+  }
+  return result;
+}
+
+// Bits of the random weights of the batch test. A batch with a bad
+// response passes with probability at most 2^-64.
+const unsigned int BATCH_WEIGHT_BITS = 64;
+
+// Whether G is a safe prime 2q + 1, i.e. whether G and (G - 1) / 2 are
+// both prime. The answers of a request carry G themselves, so the batch
+// test cannot take it for granted; the two primality tests cost more than
+// a batch, so the outcome is kept per modulus.
+inline bool is_safe_prime_modulus(const CryptoPP::Integer &G)
+{
+  static std::mutex m;
+  static std::map<std::string, bool> known;
+
+  std::string key(G.MinEncodedSize(), '\0');
+  G.Encode((CryptoPP::byte *)&key[0], key.size());
+  {
+    std::lock_guard<std::mutex> lock(m);
+    auto it = known.find(key);
+    if (it != known.end()) {
+      return it->second;
+    }
+  }
+
+  bool safe = G.IsOdd() && CryptoPP::IsPrime(G >> 1) && CryptoPP::IsPrime(G);
+
+  std::lock_guard<std::mutex> lock(m);
+  // Moduli are chosen by the requesters, so the map must not grow forever
+  if (known.size() >= 1024) {
+    known.clear();
+  }
+  known[key] = safe;
+  return safe;
+}
+
+// Small-exponent batch test (Bellare, Garay, Rabin) over every tryout of
+// answers, which all have to be over the same group. With a random short
+// weight w_i per tryout, the checks of verify_answer are folded into
+//
+//   g^{sum w_i res_i} == prod g^{r_i}^{w_i} * prod g_g_ab_p_r^{sum of w_i of its '1's}
+//
+// i.e. one fixed-base exponentiation and one multi-exponentiation with
+// 64-bit exponents, whose squarings all the bases share. The test is only
+// sound in a group of prime order: G has to be a safe prime 2q + 1 with g
+// of order q, and the other bases are required to be quadratic residues,
+// i.e. in the same subgroup.
+//
+// Returns false when any tryout might be bad or G is not a safe prime;
+// verify_answer then tells which tryouts fail.
+inline bool batch_verify(const std::vector<const ZkpAnswer *> &answers,
+    CryptoPP::RandomNumberGenerator &rnd, ThreadPool &pool = ThreadPool::shared())
+{
+  if (answers.empty()) {
+    return true;
+  }
+
+  const CryptoPP::Integer &G = answers[0]->G;
+  const CryptoPP::Integer &g = answers[0]->g;
+  const CryptoPP::Integer q = G >> 1;
+
+  if (!is_safe_prime_modulus(G)) {
+    return false;
+  }
+
+  auto base = FixedBaseCache::shared().table(G, g);
+  auto mont = MontgomeryCache::shared().context(G);
+
+  if (base->exponentiate(q) != CryptoPP::Integer::One()) {
+    return false;
+  }
+
+  auto in_subgroup = [&](const CryptoPP::Integer &x) {
+    return x > CryptoPP::Integer::Zero() && x < G && CryptoPP::Jacobi(x, G) == 1;
+  };
+
+  std::vector<CryptoPP::Integer> bases;
+  std::vector<CryptoPP::Integer> weights;
+  CryptoPP::Integer exponent;
+
+  for (const ZkpAnswer *answer : answers) {
+    const size_t K = answer->req.size();
+    if (answer->G != G || answer->g != g) {
+      throw std::invalid_argument("answers of a batch differ in group");
+    }
+    if (answer->g_r_i.size() != K || answer->res.size() != K) {
+      throw std::invalid_argument("answer does not match the request");
+    }
+
+    CryptoPP::Integer y = answer->g_g_ab_p_r % G;
+    CryptoPP::Integer y_weight;
+
+    for (size_t i = 0; i < K; i++) {
+      char c = answer->req[i];
+      if ((c != '0' && c != '1') || answer->res[i].IsNegative() || !in_subgroup(answer->g_r_i[i])) {
+        return false;
+      }
+
+      CryptoPP::Integer w(rnd, BATCH_WEIGHT_BITS);
+      exponent += w * answer->res[i];
+      if (c == '1') {
+        y_weight += w;
+      }
+
+      bases.push_back(answer->g_r_i[i]);
+      weights.push_back(w);
+    }
+
+    if (!y_weight.IsZero()) {
+      if (!in_subgroup(y)) {
+        return false;
+      }
+      bases.push_back(y);
+      weights.push_back(y_weight);
+    }
+  }
+
+  // The bases are split over the workers, each chunk with its own chain
+  // of squarings.
+  const size_t chunks = std::max<size_t>(1, std::min(bases.size(), pool.size() + 1));
+  std::vector<CryptoPP::Integer> partial(chunks);
+
+  pool.parallel_for(chunks, [&](size_t c) {
+    size_t begin = bases.size() * c / chunks;
+    size_t end = bases.size() * (c + 1) / chunks;
+
+    partial[c] = mont->multi_exponentiate(
+        std::vector<CryptoPP::Integer>(bases.begin() + begin, bases.begin() + end),
+        std::vector<CryptoPP::Integer>(weights.begin() + begin, weights.begin() + end));
+  });
+
+  CryptoPP::Integer rhs = CryptoPP::Integer::One();
+  for (auto &p : partial) {
+    rhs = mont->multiply(rhs, p);
+  }
+
+  return base->exponentiate(exponent % q) == rhs;
+}
+
+// Failed tryouts of each answer, as verify_answer gives them. The answers
+// are batch tested per group first, so that e.g. all the ANSWER TXNs of a
+// block cost one pass; only the answers of a group whose batch fails are
+// checked tryout by tryout.
+inline std::vector<std::vector<size_t>> verify_answers(const std::vector<ZkpAnswer> &answers,
+    ThreadPool &pool = ThreadPool::shared())
+{
+  std::map<std::string, std::vector<size_t>> groups;
+  for (size_t i = 0; i < answers.size(); i++) {
+    groups[group_key(answers[i].G, answers[i].g)].push_back(i);
+  }
+
+  std::vector<std::vector<size_t>> failed(answers.size());
+  for (auto &kv : groups) {
+    std::vector<const ZkpAnswer *> batch;
+    for (size_t i : kv.second) {
+      batch.push_back(&answers[i]);
+    }
+
+    if (batch_verify(batch, thread_rng(), pool)) {
+      continue;
+    }
+
+    for (size_t i : kv.second) {
+      failed[i] = verify_answer(answers[i], pool);
+    }
+  }
+  return failed;
+}
+
+#endif
@@ -1,7 +1,7 @@
 // cSpell:ignore txn, merkle, txns, deserialized
 const express = require('express');
 const ZMQ = require('zmq');
-const sock = ZMQ.socket('req');
+const sock = ZMQ.socket('dealer');
 const passport = require('passport');
 const session = require('express-session');
 const redis_session = require('connect-redis')(session);
@@ -4,6 +4,7 @@ module.exports = (function () {
     const node_rsa = require('node-rsa');
     const crypto = require('crypto');
     const stable_stringify = require('json-stable-stringify');
+    const named_groups = require('./named_groups.js');
 
     class Transaction {
 
@@ -74,8 +75,11 @@ module.exports = (function () {
             // DATA Txn
             if (this.type == 0) {
                 txn_payload = {
-                    G: p.G.toString(16),
-                    g: p.g.toString(16),
+                    // A txn over a named group carries only the
+                    // id of the group instead of G and g
+                    G: p.group ? undefined : p.G.toString(16),
+                    g: p.group ? undefined : p.g.toString(16),
+                    group: p.group,
                     g_a: p.g_a.toString(16),
                     g_r: p.g_r.toString(16),
                     K: p.K,
@@ -125,9 +129,12 @@ module.exports = (function () {
 
             this.payload = {};
             if (data.type == 0) {
+                // G and g of a named group come from its id
+                const group = data.group ? named_groups.named_group(data.group) : null;
                 this.payload = {
-                    G: big_int(data.G, 16),
-                    g: big_int(data.g, 16),
+                    G: group ? group.G : big_int(data.G, 16),
+                    g: group ? group.g : big_int(data.g, 16),
+                    group: data.group,
                     g_a: big_int(data.g_a, 16),
                     g_r: big_int(data.g_r, 16),
                     K: data.K,
@@ -232,6 +239,17 @@ module.exports = (function () {
             throw "Invalid field 'g' is requested from block with type " + this.type;
         }
 
+        /**
+         * @returns {String} Returns the id of the named group of Data Txn, or
+         * undefined when the txn carries G and g itself
+         */
+        get_group() {
+            if (this.type == 0) {
+                return this.payload.group;
+            }
+            throw "Invalid field 'group' is requested from block with type " + this.type;
+        }
+
         /**
          * @returns {BigInteger} Returns g^r of Data Txn in a big integer object
          */
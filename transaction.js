@@ -76,8 +76,11 @@ module.exports = function (dependencies) {
             // DATA Txn
             if (this.type == 0) {
                 txn_payload = {
+                    // A txn over a named group carries only the
+                    // id of the group instead of G and g
                     G: p.G,
                     g: p.g,
+                    group: p.group,
                     g_a: p.g_a,
                     g_r: p.g_r,
                     K: p.K,
@@ -131,6 +134,7 @@ module.exports = function (dependencies) {
                 this.payload = {
                     G: data.G,
                     g: data.g,
+                    group: data.group,
                     g_a: data.g_a,
                     g_r: data.g_r,
                     K: data.K,
@@ -235,6 +239,17 @@ module.exports = function (dependencies) {
             throw "Invalid field 'g' is requested from block with type " + this.type;
         }
 
+        /**
+         * @returns {String} Returns the id of the named group of Data Txn, or
+         * undefined when the txn carries G and g itself
+         */
+        get_group() {
+            if (this.type == 0) {
+                return this.payload.group;
+            }
+            throw "Invalid field 'group' is requested from block with type " + this.type;
+        }
+
         /**
          * @returns {BigInteger} Returns g^r of Data Txn in a big integer object
          */
@@ -236,6 +236,7 @@ module.exports = function(dependencies) {
                     type : 2,
                     G : data_txn.get_G(),
                     g : data_txn.get_g(),
+                    group : data_txn.get_group(),
                     g_b : request_txn.get_g_b(),
                     r_i : saved_txn.secret.r_i,
                     r : saved_txn.secret.r,
@@ -97,6 +97,7 @@ module.exports = function (dependencies) {
     const txn_payload = {
       G: txn_data.G,
       g: txn_data.g,
+      group: txn_data.group,
       g_a: txn_data.g_a,
       g_r: txn_data.g_r,
       K: txn_data.K,
@@ -32,8 +32,8 @@ module.exports = function (dependencies) {
     waiting_txn.get(token)(data);
   });
 
+  // The calculator takes the whole frame as the JSON request
   const send_data = function (data) {
-    data += "END{}OF{}JSON{}DATA";
     sock.send(data);
   }
   return {